@@ -17,6 +17,7 @@ public class IndicatorSystem : ModuleRules
         { 
             "CoreUObject", 
             "Engine", 
+            "InteractionCore",
             "Slate", 
             "SlateCore"
         });
@@ -15,6 +15,7 @@
 #include "IActorIndicatorWidget.h"
 #include "IndicatorDescriptor.h"
 #include "IndicatorManagerComponent.h"
+#include "InteractionFrameBudget.h"
 
 class FSlateRect;
 
@@ -85,6 +86,11 @@ EActiveTimerReturnType SActorCanvas::UpdateCanvas(double InCurrentTime, float In
 {
 	QUICK_SCOPE_CYCLE_COUNTER(STAT_SActorCanvas_UpdateCanvas);
 
+	if (PendingIndicatorWidgets.Num() > 0)
+	{
+		CreatePendingIndicatorWidgets();
+	}
+
 	if (!OptionalPaintGeometry.IsSet())
 	{
 		return EActiveTimerReturnType::Continue;
@@ -130,6 +136,9 @@ EActiveTimerReturnType SActorCanvas::UpdateCanvas(double InCurrentTime, float In
 			SetShowAnyIndicators(true);
 			bool bIndicatorsChanged = false;
 
+			// Update the cheap per-indicator state first, projecting them is what the budget is spent on
+			ProjectionQueue.Reset();
+
 			for (int32 ChildIdx = 0; ChildIdx < CanvasChildren.Num(); ++ChildIdx)
 			{
 				SActorCanvas::FSlot& CurChild = CanvasChildren[ChildIdx];
@@ -167,6 +176,7 @@ EActiveTimerReturnType SActorCanvas::UpdateCanvas(double InCurrentTime, float In
 
 				if (!CurChild.GetIsIndicatorVisible())
 				{
+					CurChild.FramesDeferred = 0;
 					bIndicatorsChanged |= CurChild.bIsDirty();
 					CurChild.ClearDirtyFlag();
 					continue;
@@ -179,6 +189,37 @@ EActiveTimerReturnType SActorCanvas::UpdateCanvas(double InCurrentTime, float In
 					bIndicatorsChanged = true;
 				}
 
+				// Indicators on screen are projected first, indicators that were deferred gain priority until it's their turn
+				const float Priority = FInteractionFrameBudget::GetAgedPriority(CurChild.HasValidScreenPosition() ? 1.f : 0.f, CurChild.FramesDeferred);
+				ProjectionQueue.Emplace(Priority, ChildIdx);
+			}
+
+			FInteractionFrameBudget& FrameBudget = FInteractionFrameBudget::Get();
+			if (FrameBudget.GetBudget(EInteractionBudgetCategory::IndicatorProjection) > 0.0)
+			{
+				ProjectionQueue.StableSort([](const TPair<float, int32>& A, const TPair<float, int32>& B)
+				{
+					return A.Key > B.Key;
+				});
+			}
+
+			int32 NumDeferred = 0;
+			for (const TPair<float, int32>& QueuedChild : ProjectionQueue)
+			{
+				SActorCanvas::FSlot& CurChild = CanvasChildren[QueuedChild.Value];
+				UIndicatorDescriptor* Indicator = CurChild.Indicator;
+
+				// Out of budget, the indicator keeps its last screen position until the next frame
+				if (!FrameBudget.HasBudget(EInteractionBudgetCategory::IndicatorProjection))
+				{
+					++CurChild.FramesDeferred;
+					++NumDeferred;
+					continue;
+				}
+
+				FInteractionBudgetScope BudgetScope(EInteractionBudgetCategory::IndicatorProjection);
+				CurChild.FramesDeferred = 0;
+
 				FVector ScreenPositionWithDepth;
 				FIndicatorProjection Projection;
 				const bool bSuccess = Projection.Project(*Indicator, ProjectionData, PaintGeometry.Size, OUT ScreenPositionWithDepth);
@@ -210,6 +251,11 @@ EActiveTimerReturnType SActorCanvas::UpdateCanvas(double InCurrentTime, float In
 				CurChild.ClearDirtyFlag();
 			}
 
+			if (NumDeferred > 0)
+			{
+				FrameBudget.ReportDeferred(EInteractionBudgetCategory::IndicatorProjection, NumDeferred);
+			}
+
 			if (bIndicatorsChanged)
 			{
 				Invalidate(EInvalidateWidgetReason::Paint);
@@ -495,6 +541,7 @@ void SActorCanvas::OnIndicatorRemoved(UIndicatorDescriptor* Indicator)
 
 	AllIndicators.Remove(Indicator);
 	InactiveIndicators.Remove(Indicator);
+	PendingIndicatorWidgets.Remove(Indicator);
 }
 
 void SActorCanvas::AddIndicatorForEntry(UIndicatorDescriptor* Indicator)
@@ -513,32 +560,76 @@ void SActorCanvas::AddIndicatorForEntry(UIndicatorDescriptor* Indicator)
 					return;
 				}
 
-				// Create the widget from the pool.
-				if (UUserWidget* IndicatorWidget = IndicatorPool.GetOrCreateInstance(TSubclassOf<UUserWidget>(IndicatorClass.Get())))
+				// Out of budget, the widget is created by one of the next canvas updates
+				if (!FInteractionFrameBudget::Get().HasBudget(EInteractionBudgetCategory::IndicatorWidgets))
 				{
-					if (IndicatorWidget->GetClass()->ImplementsInterface(UActorIndicatorWidget::StaticClass()))
-					{
-						IActorIndicatorWidget::Execute_BindIndicator(IndicatorWidget, Indicator);
-					}
-
-					Indicator->IndicatorWidget = IndicatorWidget;
-
-					InactiveIndicators.Remove(Indicator);
-
-					AddActorSlot(Indicator)
-					[
-						SAssignNew(Indicator->CanvasHost, SBox)
-						[
-							IndicatorWidget->TakeWidget()
-						]
-					];
+					PendingIndicatorWidgets.Add(Indicator);
+					FInteractionFrameBudget::Get().ReportDeferred(EInteractionBudgetCategory::IndicatorWidgets);
+					return;
 				}
+
+				CreateIndicatorWidget(Indicator, IndicatorClass.Get());
 			}
 		});
 		StartAsyncLoading();
 	}
 }
 
+void SActorCanvas::CreateIndicatorWidget(UIndicatorDescriptor* Indicator, TSubclassOf<UUserWidget> IndicatorClass)
+{
+	FInteractionBudgetScope BudgetScope(EInteractionBudgetCategory::IndicatorWidgets);
+
+	// Create the widget from the pool.
+	if (UUserWidget* IndicatorWidget = IndicatorPool.GetOrCreateInstance(IndicatorClass))
+	{
+		if (IndicatorWidget->GetClass()->ImplementsInterface(UActorIndicatorWidget::StaticClass()))
+		{
+			IActorIndicatorWidget::Execute_BindIndicator(IndicatorWidget, Indicator);
+		}
+
+		Indicator->IndicatorWidget = IndicatorWidget;
+
+		InactiveIndicators.Remove(Indicator);
+
+		AddActorSlot(Indicator)
+		[
+			SAssignNew(Indicator->CanvasHost, SBox)
+			[
+				IndicatorWidget->TakeWidget()
+			]
+		];
+	}
+}
+
+void SActorCanvas::CreatePendingIndicatorWidgets()
+{
+	FInteractionFrameBudget& FrameBudget = FInteractionFrameBudget::Get();
+
+	// Oldest first, so every deferred widget gets its turn
+	int32 NumProcessed = 0;
+	for (; NumProcessed < PendingIndicatorWidgets.Num(); ++NumProcessed)
+	{
+		if (!FrameBudget.HasBudget(EInteractionBudgetCategory::IndicatorWidgets))
+		{
+			break;
+		}
+
+		// The indicator could have been removed while it was waiting
+		UIndicatorDescriptor* Indicator = PendingIndicatorWidgets[NumProcessed].Get();
+		if (Indicator && AllIndicators.Contains(Indicator) && !Indicator->CanvasHost.IsValid())
+		{
+			CreateIndicatorWidget(Indicator, Indicator->GetIndicatorClass().Get());
+		}
+	}
+
+	PendingIndicatorWidgets.RemoveAt(0, NumProcessed, EAllowShrinking::No);
+
+	if (PendingIndicatorWidgets.Num() > 0)
+	{
+		FrameBudget.ReportDeferred(EInteractionBudgetCategory::IndicatorWidgets, PendingIndicatorWidgets.Num());
+	}
+}
+
 void SActorCanvas::RemoveIndicatorForEntry(UIndicatorDescriptor* Indicator)
 {
 	if (UUserWidget* IndicatorWidget = Indicator->IndicatorWidget.Get())
@@ -48,6 +48,7 @@ public:
 			, bDirty(true)
 			, bWasIndicatorClamped(false)
 			, bWasIndicatorClampedStatusChanged(false)
+			, FramesDeferred(0)
 		{
 		}
 
@@ -210,6 +211,9 @@ public:
 		 */
 		mutable uint8 bWasIndicatorClamped : 1;
 		mutable uint8 bWasIndicatorClampedStatusChanged : 1;
+
+		/** Number of canvas updates the projection of the indicator was deferred for, because the frame budget was spent */
+		int32 FramesDeferred;
 	};
 
 	/** ActorCanvas-specific slot class */
@@ -259,6 +263,12 @@ private:
 	/** Removes the indicator for the given entry */
 	void RemoveIndicatorForEntry(UIndicatorDescriptor* Indicator);
 
+	/** Creates the widget of the given indicator from the pool and adds its slot */
+	void CreateIndicatorWidget(UIndicatorDescriptor* Indicator, TSubclassOf<UUserWidget> IndicatorClass);
+
+	/** Creates the widgets that were deferred, as many as the frame budget allows */
+	void CreatePendingIndicatorWidgets();
+
 	using FScopedWidgetSlotArguments = TPanelChildren<FSlot>::FScopedWidgetSlotArguments;
 	FScopedWidgetSlotArguments AddActorSlot(UIndicatorDescriptor* Indicator);
 	int32 RemoveActorSlot(const TSharedRef<SWidget>& SlotWidget);
@@ -285,6 +295,12 @@ private:
 
 	/** List of all inactive indicators */
 	TArray<UIndicatorDescriptor*> InactiveIndicators;
+
+	/** Indicators whose widget class is loaded but whose widget creation was deferred, because the frame budget was spent */
+	TArray<TWeakObjectPtr<UIndicatorDescriptor>> PendingIndicatorWidgets;
+
+	/** Scratch list of (priority, child index) of the indicators to project, kept around to avoid reallocating every update */
+	TArray<TPair<float, int32>> ProjectionQueue;
 	
 	/** Context struct for the local player owning this canvas */
 	FLocalPlayerContext LocalPlayerContext;
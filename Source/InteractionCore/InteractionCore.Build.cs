@@ -17,7 +17,9 @@ public class InteractionCore : ModuleRules
 
         PrivateDependencyModuleNames.AddRange(new []
         { 
+            "AIModule",
             "CoreUObject", 
+            "DeveloperSettings",
             "Engine",
         });
     }
@@ -3,7 +3,10 @@
 
 #include "Abilities/GameplayAbilityTargetActor_Interact.h"
 
+#include "InteractionCoreStats.h"
+#include "InteractionScanSubsystem.h"
 #include "GameFramework/LightWeightInstanceSubsystem.h"
+#include "Interfaces/IInteractionScanner.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(GameplayAbilityTargetActor_Interact)
 
@@ -12,8 +15,47 @@ AGameplayAbilityTargetActor_Interact::AGameplayAbilityTargetActor_Interact(const
 {
 }
 
+bool AGameplayAbilityTargetActor_Interact::TryReuseScanResult(const AActor* InSourceActor, FHitResult& OutHit)
+{
+	const UInteractionScanSubsystem* ScanSubsystem = UInteractionScanSubsystem::Get(InSourceActor);
+	if (ScanSubsystem == nullptr)
+	{
+		return false;
+	}
+
+	FInteractionScanResult ScanResult;
+	if (!ScanSubsystem->FindLatestScanResult(InSourceActor, MaxScanResultAge, ScanResult))
+	{
+		return false;
+	}
+
+	// The scan doesn't know about our filter, so we have to trace ourselves if the hit doesn't pass it
+	if (ScanResult.Hit.bBlockingHit && Filter.Filter.IsValid() && !Filter.FilterPassesForActor(ScanResult.Hit.HitObjectHandle.FetchActor()))
+	{
+		return false;
+	}
+
+	OutHit = ScanResult.Hit;
+	ReusedScanOptions = MoveTemp(ScanResult.Options);
+	return true;
+}
+
 FHitResult AGameplayAbilityTargetActor_Interact::PerformTrace(AActor* InSourceActor)
 {
+	ReusedScanOptions.Reset();
+
+	FHitResult Hit;
+	if (bReuseScanResults && TryReuseScanResult(InSourceActor, Hit))
+	{
+		if (!Hit.bBlockingHit)
+		{
+			Hit.Location = Hit.TraceEnd;
+		}
+
+		UpdateReticle(Hit);
+		return Hit;
+	}
+
 	constexpr bool bTraceComplex = false;
 	const TArray ActorsToIgnore = { InSourceActor };
 
@@ -27,7 +69,7 @@ FHitResult AGameplayAbilityTargetActor_Interact::PerformTrace(AActor* InSourceAc
 	// Effective on the server and local client only
 	AimWithPlayerController(InSourceActor, Params, TraceStart, TraceEnd);
 
-	FHitResult Hit;
+	INC_DWORD_STAT(STAT_InteractionTraces);
 	LineTraceWithFilter(Hit, InSourceActor->GetWorld(), Filter, TraceStart, TraceEnd, TraceProfile.Name, Params);
 
 	// Default to the end of the trace line if we don't hit anything.
@@ -36,16 +78,7 @@ FHitResult AGameplayAbilityTargetActor_Interact::PerformTrace(AActor* InSourceAc
 		Hit.Location = TraceEnd;
 	}
 
-	if (AGameplayAbilityWorldReticle* Reticle = ReticleActor.Get())
-	{
-		const bool bHitActor = (Hit.bBlockingHit && Hit.HitObjectHandle.IsValid());
-		const FVector ReticleLocation = (bHitActor && Reticle->bSnapToTargetedActor)
-			? FLightWeightInstanceSubsystem::Get().GetLocation(Hit.HitObjectHandle)
-			: Hit.Location;
-
-		Reticle->SetActorLocation(ReticleLocation);
-		Reticle->SetIsTargetAnActor(bHitActor);
-	}
+	UpdateReticle(Hit);
 
 #if ENABLE_DRAW_DEBUG
 	if (bDebug)
@@ -57,3 +90,17 @@ FHitResult AGameplayAbilityTargetActor_Interact::PerformTrace(AActor* InSourceAc
 
 	return Hit;
 }
+
+void AGameplayAbilityTargetActor_Interact::UpdateReticle(const FHitResult& Hit)
+{
+	if (AGameplayAbilityWorldReticle* Reticle = ReticleActor.Get())
+	{
+		const bool bHitActor = (Hit.bBlockingHit && Hit.HitObjectHandle.IsValid());
+		const FVector ReticleLocation = (bHitActor && Reticle->bSnapToTargetedActor)
+			? FLightWeightInstanceSubsystem::Get().GetLocation(Hit.HitObjectHandle)
+			: Hit.Location;
+
+		Reticle->SetActorLocation(ReticleLocation);
+		Reticle->SetIsTargetAnActor(bHitActor);
+	}
+}
@@ -0,0 +1,427 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+
+#include "Components/InstancedInteractableComponent.h"
+
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/LightWeightInstanceManager.h"
+#include "InteractableIndexSubsystem.h"
+#include "InteractableIndexTypes.h"
+#include "InteractionCoreSettings.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(InstancedInteractableComponent)
+
+UInstancedInteractableComponent::UInstancedInteractableComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+UInstancedInteractableComponent* UInstancedInteractableComponent::FindForInstancedComponent(
+	const UInstancedStaticMeshComponent* InstancedComponent)
+{
+	const AActor* Owner = InstancedComponent ? InstancedComponent->GetOwner() : nullptr;
+	if (Owner == nullptr)
+	{
+		return nullptr;
+	}
+
+	TInlineComponentArray<UInstancedInteractableComponent*> InstancedInteractables(Owner);
+	for (UInstancedInteractableComponent* InstancedInteractable : InstancedInteractables)
+	{
+		if (InstancedInteractable->GetInstancedComponent() == InstancedComponent)
+		{
+			return InstancedInteractable;
+		}
+	}
+
+	return nullptr;
+}
+
+void UInstancedInteractableComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	if (InstancedComponent == nullptr)
+	{
+		if (const AActor* Owner = GetOwner())
+		{
+			InstancedComponent = Owner->FindComponentByClass<UInstancedStaticMeshComponent>();
+		}
+	}
+
+	if (!InstanceIndexUpdatedHandle.IsValid())
+	{
+		InstanceIndexUpdatedHandle = FInstancedStaticMeshDelegates::OnInstanceIndexUpdated.AddUObject(this, &ThisClass::OnInstanceIndexUpdated);
+	}
+}
+
+void UInstancedInteractableComponent::OnUnregister()
+{
+	FInstancedStaticMeshDelegates::OnInstanceIndexUpdated.Remove(InstanceIndexUpdatedHandle);
+	InstanceIndexUpdatedHandle.Reset();
+
+	Super::OnUnregister();
+}
+
+void UInstancedInteractableComponent::GatherInteractionOptions(
+	const FInteractionQuery& Query, FInteractionOptionsBuilder& OptionsBuilder)
+{
+	const int32 InstanceIndex = OptionsBuilder.GetInstanceIndex();
+
+	// No specific instance, report everything any of our instances could provide
+	if (InstanceIndex == INDEX_NONE)
+	{
+		for (const FInteractionOption& Option : InstanceOptions)
+		{
+			OptionsBuilder.AddInteractionOption(Option);
+		}
+		return;
+	}
+
+	if (!IsInstanceEnabled(InstanceIndex))
+	{
+		return;
+	}
+
+	const uint8 OptionIndex = InstanceStates.IsValidIndex(InstanceIndex) ? InstanceStates[InstanceIndex].OptionIndex : 0;
+	if (!InstanceOptions.IsValidIndex(OptionIndex))
+	{
+		return;
+	}
+
+	// Check the stored option rather than the copy, so its compiled tag requirements are kept
+	if (!OptionsBuilder.MeetsTagRequirements(InstanceOptions[OptionIndex]))
+	{
+		return;
+	}
+
+	FInteractionOption Option = InstanceOptions[OptionIndex];
+	Option.InteractableInstanceIndex = InstanceIndex;
+	OptionsBuilder.AddInteractionOption(Option);
+}
+
+void UInstancedInteractableComponent::GatherInteractableIndexEntries(TArray<FInteractableIndexEntry>& OutEntries) const
+{
+	if (InstancedComponent == nullptr)
+	{
+		IInteractableTarget::GatherInteractableIndexEntries(OutEntries);
+		return;
+	}
+
+	// One entry per instance, so queries can resolve the exact instance without a trace
+	const int32 InstanceCount = InstancedComponent->GetInstanceCount();
+	OutEntries.Reserve(OutEntries.Num() + InstanceCount);
+
+	GatherInstancedComponentIndexEntries(0, InstanceCount, OutEntries);
+}
+
+void UInstancedInteractableComponent::GatherInteractableInstanceIndexEntries(int32 InstanceIndex, TArray<FInteractableIndexEntry>& OutEntries) const
+{
+	if (InstancedComponent == nullptr)
+	{
+		IInteractableTarget::GatherInteractableInstanceIndexEntries(InstanceIndex, OutEntries);
+		return;
+	}
+
+	const int32 ComponentInstanceIndex = GetInstancedComponentIndex(InstanceIndex);
+	if (ComponentInstanceIndex != INDEX_NONE)
+	{
+		GatherInstancedComponentIndexEntries(ComponentInstanceIndex, ComponentInstanceIndex + 1, OutEntries);
+	}
+}
+
+void UInstancedInteractableComponent::GatherInstancedComponentIndexEntries(
+	int32 FirstComponentInstanceIndex, int32 EndComponentInstanceIndex, TArray<FInteractableIndexEntry>& OutEntries) const
+{
+	check(InstancedComponent);
+
+	const UStaticMesh* StaticMesh = InstancedComponent->GetStaticMesh();
+	const FBox MeshBounds = StaticMesh ? StaticMesh->GetBounds().GetBox() : FBox(ForceInit);
+
+	// Instances are categorized by the tags of their option on top of our own
+	FGameplayTagContainer CategoryTags;
+	GetInteractableCategoryTags(CategoryTags);
+
+	const UInteractionCoreSettings* Settings = UInteractionCoreSettings::Get();
+	const uint64 BaseCategoryMask = Settings->MakeCategoryMask(CategoryTags);
+	const FGameplayTag BaseOptionTemplateId = GetInteractableOptionTemplateId();
+
+	TArray<uint64, TInlineAllocator<8>> OptionCategoryMasks;
+	for (const FInteractionOption& Option : InstanceOptions)
+	{
+		OptionCategoryMasks.Add(BaseCategoryMask | Settings->MakeCategoryMask(Option.InteractionTags));
+	}
+
+	for (int32 ComponentInstanceIdx = FirstComponentInstanceIndex; ComponentInstanceIdx < EndComponentInstanceIndex; ++ComponentInstanceIdx)
+	{
+		// Entries are keyed like hits are, by the light weight instance on managers
+		const int32 InstanceIdx = GetInstanceIndexFromInstancedComponent(ComponentInstanceIdx);
+		if (!IsInstanceEnabled(InstanceIdx))
+		{
+			continue;
+		}
+
+		FTransform InstanceTransform;
+		if (!InstancedComponent->GetInstanceTransform(ComponentInstanceIdx, InstanceTransform, /*bWorldSpace=*/ true))
+		{
+			continue;
+		}
+
+		FInteractableIndexEntry& Entry = OutEntries.AddDefaulted_GetRef();
+		Entry.Target = const_cast<UInstancedInteractableComponent*>(this);
+		Entry.InstanceIndex = InstanceIdx;
+		Entry.Location = InstanceTransform.GetLocation();
+		Entry.Bounds = MeshBounds.IsValid ? MeshBounds.TransformBy(InstanceTransform) : FBox(Entry.Location, Entry.Location);
+
+		const uint8 OptionIndex = InstanceStates.IsValidIndex(InstanceIdx) ? InstanceStates[InstanceIdx].OptionIndex : 0;
+		Entry.CategoryMask = OptionCategoryMasks.IsValidIndex(OptionIndex) ? OptionCategoryMasks[OptionIndex] : BaseCategoryMask;
+
+		// Instances built from a template refer to it, so their option doesn't have to be gathered
+		const FGameplayTag& OptionTemplateId = InstanceOptions.IsValidIndex(OptionIndex) ? InstanceOptions[OptionIndex].OptionTemplateId : BaseOptionTemplateId;
+		Entry.OptionTemplateId = OptionTemplateId.IsValid() ? OptionTemplateId : BaseOptionTemplateId;
+	}
+}
+
+void UInstancedInteractableComponent::SetInstancedComponent(UInstancedStaticMeshComponent* InInstancedComponent)
+{
+	if (InstancedComponent != InInstancedComponent)
+	{
+		InstancedComponent = InInstancedComponent;
+		InstanceStates.Reset();
+
+		if (UInteractableIndexSubsystem* IndexSubsystem = UInteractableIndexSubsystem::Get(this))
+		{
+			IndexSubsystem->RegisterInteractable(this);
+		}
+	}
+}
+
+void UInstancedInteractableComponent::SetInstanceEnabled(int32 InstanceIndex, bool bEnabled)
+{
+	if (InstanceIndex < 0)
+	{
+		return;
+	}
+
+	// Don't grow the state array just to store the default
+	if (bEnabled && !InstanceStates.IsValidIndex(InstanceIndex))
+	{
+		return;
+	}
+
+	FInstancedInteractableState& State = GetMutableInstanceState(InstanceIndex);
+	if (State.bEnabled != bEnabled)
+	{
+		State.bEnabled = bEnabled;
+		UpdateInstanceInIndex(InstanceIndex);
+	}
+}
+
+bool UInstancedInteractableComponent::IsInstanceEnabled(int32 InstanceIndex) const
+{
+	if (InstanceIndex < 0)
+	{
+		return false;
+	}
+
+	if (InstancedComponent)
+	{
+		const int32 ComponentInstanceIndex = GetInstancedComponentIndex(InstanceIndex);
+		if (ComponentInstanceIndex == INDEX_NONE || ComponentInstanceIndex >= InstancedComponent->GetInstanceCount())
+		{
+			return false;
+		}
+	}
+
+	return !InstanceStates.IsValidIndex(InstanceIndex) || InstanceStates[InstanceIndex].bEnabled;
+}
+
+void UInstancedInteractableComponent::SetInstanceOptionIndex(int32 InstanceIndex, int32 OptionIndex)
+{
+	if (InstanceIndex < 0)
+	{
+		return;
+	}
+
+	if (!ensureMsgf(InstanceOptions.IsValidIndex(OptionIndex) && OptionIndex <= MAX_uint8, TEXT("Invalid option index %d for %s"), OptionIndex, *GetPathName()))
+	{
+		return;
+	}
+
+	FInstancedInteractableState& State = GetMutableInstanceState(InstanceIndex);
+	if (State.OptionIndex != OptionIndex)
+	{
+		State.OptionIndex = static_cast<uint8>(OptionIndex);
+		UpdateInstanceInIndex(InstanceIndex);
+	}
+}
+
+int32 UInstancedInteractableComponent::GetInstancedComponentIndex(int32 InstanceIndex) const
+{
+	if (InstanceIndex < 0)
+	{
+		return INDEX_NONE;
+	}
+
+	if (IsLightWeightInstanceManager())
+	{
+		return CastChecked<ALightWeightInstanceManager>(GetOwner())->ConvertLightWeightIndexToCollisionIndex(InstanceIndex);
+	}
+
+	return InstanceIndex;
+}
+
+int32 UInstancedInteractableComponent::GetInstanceIndexFromInstancedComponent(int32 ComponentInstanceIndex) const
+{
+	if (ComponentInstanceIndex < 0)
+	{
+		return INDEX_NONE;
+	}
+
+	if (IsLightWeightInstanceManager())
+	{
+		return CastChecked<ALightWeightInstanceManager>(GetOwner())->ConvertCollisionIndexToLightWeightIndex(ComponentInstanceIndex);
+	}
+
+	return ComponentInstanceIndex;
+}
+
+bool UInstancedInteractableComponent::IsLightWeightInstanceManager() const
+{
+	return GetOwner() && GetOwner()->IsA<ALightWeightInstanceManager>();
+}
+
+FInstancedInteractableState& UInstancedInteractableComponent::GetMutableInstanceState(int32 InstanceIndex)
+{
+	check(InstanceIndex >= 0);
+
+	if (!InstanceStates.IsValidIndex(InstanceIndex))
+	{
+		InstanceStates.SetNum(InstanceIndex + 1);
+	}
+
+	return InstanceStates[InstanceIndex];
+}
+
+void UInstancedInteractableComponent::UpdateInstanceInIndex(int32 InstanceIndex)
+{
+	if (UInteractableIndexSubsystem* IndexSubsystem = UInteractableIndexSubsystem::Get(this))
+	{
+		IndexSubsystem->RegisterInteractableInstance(this, InstanceIndex);
+	}
+}
+
+void UInstancedInteractableComponent::OnInstanceIndexUpdated(
+	UInstancedStaticMeshComponent* InInstancedComponent, TArrayView<const FInstancedStaticMeshDelegates::FInstanceIndexUpdateData> IndexUpdates)
+{
+	if (InInstancedComponent == nullptr || InInstancedComponent != InstancedComponent)
+	{
+		return;
+	}
+
+	using EUpdateType = FInstancedStaticMeshDelegates::EInstanceIndexUpdateType;
+
+	bool bReindexAll = false;
+	TArray<int32, TInlineAllocator<8>> AddedInstances;
+
+	if (IsLightWeightInstanceManager())
+	{
+		// Light weight instances keep their index when the rendered instances move around, only removed ones lose their state
+		for (const FInstancedStaticMeshDelegates::FInstanceIndexUpdateData& Update : IndexUpdates)
+		{
+			if (Update.Type == EUpdateType::Cleared || Update.Type == EUpdateType::Destroyed)
+			{
+				InstanceStates.Reset();
+				bReindexAll = true;
+			}
+			else if (Update.Type == EUpdateType::Removed)
+			{
+				for (int32 InstanceIdx = 0; InstanceIdx < InstanceStates.Num(); ++InstanceIdx)
+				{
+					if (GetInstancedComponentIndex(InstanceIdx) == INDEX_NONE)
+					{
+						InstanceStates[InstanceIdx] = FInstancedInteractableState();
+					}
+				}
+				bReindexAll = true;
+			}
+			else if (Update.Type == EUpdateType::Added)
+			{
+				AddedInstances.Add(GetInstanceIndexFromInstancedComponent(Update.Index));
+			}
+		}
+	}
+	else
+	{
+		for (const FInstancedStaticMeshDelegates::FInstanceIndexUpdateData& Update : IndexUpdates)
+		{
+			switch (Update.Type)
+			{
+			case EUpdateType::Added:
+				// The index may be reused by an instance that was removed earlier, it starts out with the default state
+				if (InstanceStates.IsValidIndex(Update.Index))
+				{
+					InstanceStates[Update.Index] = FInstancedInteractableState();
+				}
+				AddedInstances.Add(Update.Index);
+				break;
+
+			case EUpdateType::Removed:
+				if (InstanceStates.IsValidIndex(Update.Index))
+				{
+					InstanceStates[Update.Index] = FInstancedInteractableState();
+				}
+				bReindexAll = true;
+				break;
+
+			case EUpdateType::Relocated:
+				if (InstanceStates.IsValidIndex(Update.OldIndex))
+				{
+					// Copied first, growing the array for the new index could move the old state
+					const FInstancedInteractableState RelocatedState = InstanceStates[Update.OldIndex];
+					InstanceStates[Update.OldIndex] = FInstancedInteractableState();
+					GetMutableInstanceState(Update.Index) = RelocatedState;
+				}
+				else if (InstanceStates.IsValidIndex(Update.Index))
+				{
+					InstanceStates[Update.Index] = FInstancedInteractableState();
+				}
+				bReindexAll = true;
+				break;
+
+			case EUpdateType::Cleared:
+			case EUpdateType::Destroyed:
+				InstanceStates.Reset();
+				bReindexAll = true;
+				break;
+
+			default:
+				break;
+			}
+		}
+
+		// States past the last instance only hold defaults now
+		InstanceStates.SetNum(FMath::Min(InstanceStates.Num(), InstancedComponent->GetInstanceCount()));
+	}
+
+	UInteractableIndexSubsystem* IndexSubsystem = UInteractableIndexSubsystem::Get(this);
+	if (IndexSubsystem == nullptr)
+	{
+		return;
+	}
+
+	// Removed and relocated instances shift the keys of other instances, so the index entries are rebuilt as a whole
+	if (bReindexAll)
+	{
+		IndexSubsystem->RegisterInteractable(this);
+		return;
+	}
+
+	for (const int32 InstanceIdx : AddedInstances)
+	{
+		IndexSubsystem->RegisterInteractableInstance(this, InstanceIdx);
+	}
+}
@@ -0,0 +1,222 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+
+#include "Data/InteractableIndexLevelData.h"
+
+#include "Components/SceneComponent.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "InteractableIndexTypes.h"
+#include "InteractionCoreSettings.h"
+#include "InteractionStatics.h"
+#include "Interfaces/IInteractableTarget.h"
+
+#if WITH_EDITOR
+#include "Misc/DelayedAutoRegister.h"
+#include "UObject/ObjectSaveContext.h"
+#endif
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(InteractableIndexLevelData)
+
+//////////////////////////////////////////////////////////////////////////
+/// FInteractableIndexBakedRecord
+
+FArchive& operator<<(FArchive& Ar, FInteractableIndexBakedRecord& Record)
+{
+	Ar << Record.CategoryMask;
+	Ar << Record.Location;
+	Ar << Record.BoundsMin;
+	Ar << Record.BoundsMax;
+	Ar << Record.TargetIndex;
+	Ar << Record.InstanceIndex;
+	Ar << Record.OptionTemplateIndex;
+	return Ar;
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// UInteractableIndexLevelData
+
+UInteractableIndexLevelData::UInteractableIndexLevelData()
+{
+}
+
+void UInteractableIndexLevelData::Serialize(FArchive& Ar)
+{
+	Super::Serialize(Ar);
+
+	// Plain old data, so it can be loaded with a single copy
+	Records.BulkSerialize(Ar);
+}
+
+void UInteractableIndexLevelData::AppendEntries(TArray<FInteractableIndexEntry>& OutEntries) const
+{
+	OutEntries.Reserve(OutEntries.Num() + Records.Num());
+
+	for (const FInteractableIndexBakedRecord& Record : Records)
+	{
+		UObject* Target = Targets.IsValidIndex(Record.TargetIndex) ? Targets[Record.TargetIndex].Get() : nullptr;
+		if (Target == nullptr)
+		{
+			continue;
+		}
+
+		FInteractableIndexEntry& Entry = OutEntries.AddDefaulted_GetRef();
+		Entry.Target = Target;
+		Entry.InstanceIndex = Record.InstanceIndex;
+		Entry.Location = FVector(Record.Location);
+		Entry.CategoryMask = Record.CategoryMask;
+
+		if (Record.BoundsMin.X <= Record.BoundsMax.X)
+		{
+			Entry.Bounds = FBox(FVector(Record.BoundsMin), FVector(Record.BoundsMax));
+		}
+
+		if (OptionTemplateIds.IsValidIndex(Record.OptionTemplateIndex))
+		{
+			Entry.OptionTemplateId = OptionTemplateIds[Record.OptionTemplateIndex];
+		}
+	}
+}
+
+bool UInteractableIndexLevelData::CanBakeActor(const AActor* Actor)
+{
+	const USceneComponent* RootComponent = Actor->GetRootComponent();
+	return RootComponent && RootComponent->Mobility != EComponentMobility::Movable;
+}
+
+#if WITH_EDITOR
+void UInteractableIndexLevelData::BakeLevel(ULevel* Level)
+{
+	if (Level == nullptr)
+	{
+		return;
+	}
+
+	RemoveFromLevel(Level);
+
+	UInteractableIndexLevelData* LevelData = NewObject<UInteractableIndexLevelData>(Level);
+
+	TMap<UObject*, int32> TargetIndices;
+	TMap<FGameplayTag, int32> OptionTemplateIndices;
+	TArray<TScriptInterface<IInteractableTarget>> InteractableTargets;
+	TArray<FInteractableIndexEntry> Entries;
+
+	for (AActor* Actor : Level->Actors)
+	{
+		if (!IsValid(Actor) || Actor->IsEditorOnly())
+		{
+			continue;
+		}
+
+		InteractableTargets.Reset();
+		UInteractionStatics::GetInteractableTargetsFromActor(Actor, InteractableTargets);
+		if (InteractableTargets.Num() == 0)
+		{
+			continue;
+		}
+
+		if (!CanBakeActor(Actor))
+		{
+			LevelData->RuntimeActors.Add(Actor);
+			continue;
+		}
+
+		// Components of levels that are being cooked usually aren't registered, so make sure transforms and bounds are current
+		Actor->ForEachComponent<USceneComponent>(false, [](USceneComponent* SceneComponent)
+		{
+			if (!SceneComponent->IsRegistered())
+			{
+				SceneComponent->UpdateComponentToWorld();
+			}
+		});
+
+		Entries.Reset();
+		for (const TScriptInterface<IInteractableTarget>& InteractableTarget : InteractableTargets)
+		{
+			InteractableTarget->GatherInteractableIndexEntries(Entries);
+		}
+
+		for (const FInteractableIndexEntry& Entry : Entries)
+		{
+			UObject* Target = Entry.Target.Get();
+			if (Target == nullptr)
+			{
+				continue;
+			}
+
+			FInteractableIndexBakedRecord& Record = LevelData->Records.AddDefaulted_GetRef();
+			Record.CategoryMask = Entry.CategoryMask;
+			Record.Location = FVector3f(Entry.Location);
+			Record.InstanceIndex = Entry.InstanceIndex;
+
+			if (Entry.Bounds.IsValid)
+			{
+				Record.BoundsMin = FVector3f(Entry.Bounds.Min);
+				Record.BoundsMax = FVector3f(Entry.Bounds.Max);
+			}
+
+			if (const int32* TargetIndex = TargetIndices.Find(Target))
+			{
+				Record.TargetIndex = *TargetIndex;
+			}
+			else
+			{
+				Record.TargetIndex = LevelData->Targets.Add(Target);
+				TargetIndices.Add(Target, Record.TargetIndex);
+			}
+
+			if (Entry.OptionTemplateId.IsValid())
+			{
+				if (const int32* OptionTemplateIndex = OptionTemplateIndices.Find(Entry.OptionTemplateId))
+				{
+					Record.OptionTemplateIndex = *OptionTemplateIndex;
+				}
+				else
+				{
+					Record.OptionTemplateIndex = LevelData->OptionTemplateIds.Add(Entry.OptionTemplateId);
+					OptionTemplateIndices.Add(Entry.OptionTemplateId, Record.OptionTemplateIndex);
+				}
+			}
+		}
+	}
+
+	// Even a level without any interactables gets the data, so the index knows it doesn't have to look at its actors
+	Level->AddAssetUserData(LevelData);
+}
+
+void UInteractableIndexLevelData::RemoveFromLevel(ULevel* Level)
+{
+	if (Level)
+	{
+		Level->RemoveUserDataOfClass(UInteractableIndexLevelData::StaticClass());
+	}
+}
+
+namespace InteractableIndexLevelData
+{
+	/** Bakes the interactables of worlds that are being cooked, and makes sure baked data never ends up in editor saves */
+	static void OnObjectPreSave(UObject* Object, FObjectPreSaveContext SaveContext)
+	{
+		const UWorld* World = Cast<UWorld>(Object);
+		if (World == nullptr || World->PersistentLevel == nullptr)
+		{
+			return;
+		}
+
+		if (SaveContext.IsCooking() && UInteractionCoreSettings::Get()->bBakeInteractableIndexOnCook)
+		{
+			UInteractableIndexLevelData::BakeLevel(World->PersistentLevel);
+		}
+		else
+		{
+			UInteractableIndexLevelData::RemoveFromLevel(World->PersistentLevel);
+		}
+	}
+
+	static FDelayedAutoRegisterHelper RegisterBaking(EDelayedRegisterRunPhase::EndOfEngineInit, []()
+	{
+		FCoreUObjectDelegates::OnObjectPreSave.AddStatic(&OnObjectPreSave);
+	});
+}
+#endif
@@ -0,0 +1,76 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+
+#include "Data/InteractionOptionTemplates.h"
+
+#include "InteractionOption.h"
+
+#if WITH_EDITOR
+#include "Misc/DataValidation.h"
+#endif
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(InteractionOptionTemplates)
+
+#define LOCTEXT_NAMESPACE "InteractionOptionTemplates"
+
+//////////////////////////////////////////////////////////////////////////
+/// FInteractionOptionTemplate
+
+void FInteractionOptionTemplate::BuildOption(FInteractionOption& OutOption) const
+{
+	OutOption.Text = Text;
+	OutOption.SubText = SubText;
+	OutOption.InteractionAbilityToGrant = InteractionAbilityToGrant;
+	OutOption.SoftInteractionAbilityToGrant = SoftInteractionAbilityToGrant;
+	OutOption.InteractionWidgetClass = InteractionWidgetClass;
+	OutOption.InteractionTags = InteractionTags;
+	OutOption.OptionTemplateId = TemplateId;
+	OutOption.HoldDuration = HoldDuration;
+
+	// Resolved once per template, so every option added from it shares the compiled bits
+	OutOption.TagRequirements = TagRequirements;
+	OutOption.TagRequirements.Compile();
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// UInteractionOptionTemplates
+
+const FPrimaryAssetType UInteractionOptionTemplates::PrimaryAssetType(TEXT("InteractionOptionTemplates"));
+
+UInteractionOptionTemplates::UInteractionOptionTemplates()
+{
+}
+
+FPrimaryAssetId UInteractionOptionTemplates::GetPrimaryAssetId() const
+{
+	return FPrimaryAssetId(PrimaryAssetType, GetFName());
+}
+
+#if WITH_EDITOR
+EDataValidationResult UInteractionOptionTemplates::IsDataValid(FDataValidationContext& Context) const
+{
+	EDataValidationResult Result = CombineDataValidationResults(Super::IsDataValid(Context), EDataValidationResult::Valid);
+
+	TSet<FGameplayTag> SeenIds;
+	for (int32 TemplateIdx = 0; TemplateIdx < Templates.Num(); ++TemplateIdx)
+	{
+		const FGameplayTag& TemplateId = Templates[TemplateIdx].TemplateId;
+		if (!TemplateId.IsValid())
+		{
+			Context.AddError(FText::Format(LOCTEXT("InvalidTemplateId", "Template {0} has no template id."), FText::AsNumber(TemplateIdx)));
+			Result = EDataValidationResult::Invalid;
+		}
+		else if (SeenIds.Contains(TemplateId))
+		{
+			Context.AddError(FText::Format(LOCTEXT("DuplicateTemplateId", "Template id {0} is used more than once."), FText::FromName(TemplateId.GetTagName())));
+			Result = EDataValidationResult::Invalid;
+		}
+
+		SeenIds.Add(TemplateId);
+	}
+
+	return Result;
+}
+#endif
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,1019 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+
+#include "InteractableIndexSubsystem.h"
+
+#include "Data/InteractableIndexLevelData.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "CollisionQueryParams.h"
+#include "Components/SceneComponent.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/GameStateBase.h"
+#include "InteractionCoreSettings.h"
+#include "InteractionCoreStats.h"
+#include "InteractionStatics.h"
+#include "Interfaces/IInteractableTarget.h"
+#include "Tasks/Task.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(InteractableIndexSubsystem)
+
+UInteractableIndexSubsystem::UInteractableIndexSubsystem()
+{
+}
+
+UInteractableIndexSubsystem* UInteractableIndexSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+	return World ? UWorld::GetSubsystem<UInteractableIndexSubsystem>(World) : nullptr;
+}
+
+void UInteractableIndexSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &ThisClass::OnLevelAddedToWorld);
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &ThisClass::OnLevelRemovedFromWorld);
+
+	UWorld* World = GetWorld();
+	check(World);
+
+	ActorSpawnedHandle = World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &ThisClass::OnActorSpawned));
+	ActorDestroyedHandle = World->AddOnActorDestroyedHandler(FOnActorDestroyed::FDelegate::CreateUObject(this, &ThisClass::OnActorDestroyed));
+}
+
+void UInteractableIndexSubsystem::Deinitialize()
+{
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+
+	if (UWorld* World = GetWorld())
+	{
+		World->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+		World->RemoveOnActorDestroyedHandler(ActorDestroyedHandle);
+	}
+
+	// Pending builds only hold on to their own cell, so they can safely finish on their own
+	PendingBuilds.Reset();
+	PendingGathers.Reset();
+	DeferredActors.Reset();
+	Observers.Reset();
+	MovingInteractables.Reset();
+	Cells.Reset();
+
+	Super::Deinitialize();
+}
+
+void UInteractableIndexSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// Levels that were made visible before we were listening
+	for (ULevel* Level : InWorld.GetLevels())
+	{
+		if (Level && Level->bIsVisible)
+		{
+			QueueLevel(Level);
+		}
+	}
+}
+
+bool UInteractableIndexSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UInteractableIndexSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	ProcessPendingBuilds();
+	ProcessPendingGathers();
+	RecordMovingInteractables();
+}
+
+TStatId UInteractableIndexSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UInteractableIndexSubsystem, STATGROUP_Tickables);
+}
+
+void UInteractableIndexSubsystem::RegisterInteractable(const TScriptInterface<IInteractableTarget>& Interactable)
+{
+	if (Interactable == nullptr)
+	{
+		return;
+	}
+
+	AActor* Actor = UInteractionStatics::GetActorFromInteractableTarget(Interactable);
+	const ULevel* Level = Actor ? Actor->GetLevel() : nullptr;
+	if (Level == nullptr)
+	{
+		return;
+	}
+
+	const TSharedPtr<FInteractableIndexCell>* Cell = Cells.Find(Level);
+	if (Cell == nullptr)
+	{
+		// The cell is still being gathered or built, register the whole actor once it's published.
+		// Levels that aren't tracked yet will pick the interactable up when they are gathered.
+		if (IsLevelPending(Level))
+		{
+			DeferredActors.AddUnique(Actor);
+		}
+		return;
+	}
+
+	// Re-registering replaces the previous entries, e.g. after the interactable moved
+	(*Cell)->RemoveEntriesForTarget(Interactable.GetObject());
+
+	TArray<FInteractableIndexEntry> Entries;
+	Interactable->GatherInteractableIndexEntries(Entries);
+	TrackMovingInteractable(Interactable, Entries);
+
+	for (const FInteractableIndexEntry& Entry : Entries)
+	{
+		(*Cell)->AddEntry(Entry);
+	}
+
+	++IndexRevision;
+}
+
+void UInteractableIndexSubsystem::RegisterInteractableInstance(const TScriptInterface<IInteractableTarget>& Interactable, int32 InstanceIndex)
+{
+	if (Interactable == nullptr)
+	{
+		return;
+	}
+
+	// Moving interactables keep all their entries around for raycasts, so they are always registered as a whole
+	if (InstanceIndex == INDEX_NONE || Interactable->IsMovingInteractable())
+	{
+		RegisterInteractable(Interactable);
+		return;
+	}
+
+	AActor* Actor = UInteractionStatics::GetActorFromInteractableTarget(Interactable);
+	const ULevel* Level = Actor ? Actor->GetLevel() : nullptr;
+	if (Level == nullptr)
+	{
+		return;
+	}
+
+	const TSharedPtr<FInteractableIndexCell>* Cell = Cells.Find(Level);
+	if (Cell == nullptr)
+	{
+		// The whole actor is registered once the cell is published, which picks up the instance as well
+		if (IsLevelPending(Level))
+		{
+			DeferredActors.AddUnique(Actor);
+		}
+		return;
+	}
+
+	(*Cell)->RemoveEntry(FInteractableIndexEntryKey(Interactable.GetObject(), InstanceIndex));
+
+	TArray<FInteractableIndexEntry> Entries;
+	Interactable->GatherInteractableInstanceIndexEntries(InstanceIndex, Entries);
+
+	for (const FInteractableIndexEntry& Entry : Entries)
+	{
+		(*Cell)->AddEntry(Entry);
+	}
+
+	++IndexRevision;
+}
+
+void UInteractableIndexSubsystem::UnregisterInteractable(const TScriptInterface<IInteractableTarget>& Interactable)
+{
+	if (Interactable == nullptr)
+	{
+		return;
+	}
+
+	AActor* Actor = UInteractionStatics::GetActorFromInteractableTarget(Interactable);
+	const ULevel* Level = Actor ? Actor->GetLevel() : nullptr;
+	if (Level == nullptr)
+	{
+		return;
+	}
+
+	MovingInteractables.RemoveAllSwap([&Interactable](const FMovingInteractable& Moving)
+	{
+		return Moving.Target.Get() == Interactable.GetObject();
+	});
+
+	const TSharedPtr<FInteractableIndexCell>* Cell = Cells.Find(Level);
+	if (Cell && (*Cell)->RemoveEntriesForTarget(Interactable.GetObject()) > 0)
+	{
+		++IndexRevision;
+	}
+}
+
+void UInteractableIndexSubsystem::RegisterActor(AActor* Actor)
+{
+	TArray<TScriptInterface<IInteractableTarget>> InteractableTargets;
+	UInteractionStatics::GetInteractableTargetsFromActor(Actor, InteractableTargets);
+
+	for (const TScriptInterface<IInteractableTarget>& InteractableTarget : InteractableTargets)
+	{
+		RegisterInteractable(InteractableTarget);
+	}
+}
+
+void UInteractableIndexSubsystem::UnregisterActor(AActor* Actor)
+{
+	DeferredActors.Remove(Actor);
+
+	TArray<TScriptInterface<IInteractableTarget>> InteractableTargets;
+	UInteractionStatics::GetInteractableTargetsFromActor(Actor, InteractableTargets);
+
+	for (const TScriptInterface<IInteractableTarget>& InteractableTarget : InteractableTargets)
+	{
+		UnregisterInteractable(InteractableTarget);
+	}
+}
+
+void UInteractableIndexSubsystem::ForEachInteractableInSphere(
+	const FVector& Center, double Radius, const FInteractableCategoryFilter& CategoryFilter, TFunctionRef<void(const FInteractableIndexEntry&)> Func) const
+{
+	for (const TPair<TObjectKey<ULevel>, TSharedPtr<FInteractableIndexCell>>& Cell : Cells)
+	{
+		Cell.Value->ForEachEntryInSphere(Center, Radius, CategoryFilter, [&Func](const FInteractableIndexEntry& Entry)
+		{
+			// Skip interactables that were destroyed without being unregistered
+			if (Entry.Target.IsValid())
+			{
+				Func(Entry);
+			}
+		});
+	}
+}
+
+void UInteractableIndexSubsystem::QuerySphere(
+	const FVector& Center, double Radius, TArray<FInteractableIndexEntry>& OutEntries, const FInteractableCategoryFilter& CategoryFilter) const
+{
+	ForEachInteractableInSphere(Center, Radius, CategoryFilter, [&OutEntries](const FInteractableIndexEntry& Entry)
+	{
+		OutEntries.Add(Entry);
+	});
+}
+
+bool UInteractableIndexSubsystem::FindInteractable(
+	const FInteractableIndexEntryKey& Key, const FVector& Center, double Radius, FInteractableIndexEntry& OutEntry) const
+{
+	bool bFound = false;
+	ForEachInteractableInSphere(Center, Radius, FInteractableCategoryFilter(), [&Key, &OutEntry, &bFound](const FInteractableIndexEntry& Entry)
+	{
+		if (!bFound && Entry.GetKey() == Key)
+		{
+			OutEntry = Entry;
+			bFound = true;
+		}
+	});
+	return bFound;
+}
+
+void UInteractableIndexSubsystem::GetCellsInSphere(const FVector& Center, double Radius, TArray<TSharedPtr<const FInteractableIndexCell>>& OutCells) const
+{
+	const double RadiusSquared = Radius * Radius;
+	for (const TPair<TObjectKey<ULevel>, TSharedPtr<FInteractableIndexCell>>& Cell : Cells)
+	{
+		if (Cell.Value->Bounds.IsValid && FMath::SphereAABBIntersection(Center, RadiusSquared, Cell.Value->Bounds))
+		{
+			OutCells.Add(Cell.Value);
+		}
+	}
+}
+
+void UInteractableIndexSubsystem::FindNearestInteractables(
+	const FVector& Location, double MaxDistance, int32 MaxCount, TArray<FInteractableIndexEntry>& OutEntries,
+	const FInteractableCategoryFilter& CategoryFilter) const
+{
+	if (MaxCount <= 0)
+	{
+		return;
+	}
+
+	// Visit the closest cells first, so farther ones can be skipped once the heap is full
+	TArray<TPair<double, const FInteractableIndexCell*>, TInlineAllocator<16>> SortedCells;
+	for (const TPair<TObjectKey<ULevel>, TSharedPtr<FInteractableIndexCell>>& Cell : Cells)
+	{
+		if (Cell.Value->Bounds.IsValid)
+		{
+			SortedCells.Emplace(Cell.Value->Bounds.ComputeSquaredDistanceToPoint(Location), Cell.Value.Get());
+		}
+	}
+
+	SortedCells.Sort([](const TPair<double, const FInteractableIndexCell*>& A, const TPair<double, const FInteractableIndexCell*>& B)
+	{
+		return A.Key < B.Key;
+	});
+
+	TArray<TPair<double, const FInteractableIndexEntry*>> Heap;
+	for (const TPair<double, const FInteractableIndexCell*>& Cell : SortedCells)
+	{
+		if (Heap.Num() >= MaxCount && Cell.Key >= Heap.HeapTop().Key)
+		{
+			break;
+		}
+
+		Cell.Value->FindNearestEntries(Location, MaxDistance, MaxCount, CategoryFilter, Heap);
+	}
+
+	Heap.Sort([](const TPair<double, const FInteractableIndexEntry*>& A, const TPair<double, const FInteractableIndexEntry*>& B)
+	{
+		return A.Key < B.Key;
+	});
+
+	OutEntries.Reserve(OutEntries.Num() + Heap.Num());
+	for (const TPair<double, const FInteractableIndexEntry*>& Nearest : Heap)
+	{
+		OutEntries.Add(*Nearest.Value);
+	}
+}
+
+bool UInteractableIndexSubsystem::RaycastInteractable(
+	const FVector& Start, const FVector& End, const AActor* IgnoredActor, FInteractableIndexEntry& OutEntry, double& OutDistance,
+	const FInteractableCategoryFilter& CategoryFilter) const
+{
+	INC_DWORD_STAT(STAT_InteractionIndexRaycasts);
+
+	const auto IsNotIgnored = [IgnoredActor](const FInteractableIndexEntry& Entry)
+	{
+		if (IgnoredActor == nullptr)
+		{
+			return true;
+		}
+
+		const UObject* Target = Entry.Target.Get();
+		const UActorComponent* Component = Cast<UActorComponent>(Target);
+		return (Component ? Component->GetOwner() : Target) != IgnoredActor;
+	};
+
+	// Moving interactables are still in the cells with the bounds they were registered with, they are tested below instead
+	const auto IsStaticAndNotIgnored = [&IsNotIgnored](const FInteractableIndexEntry& Entry)
+	{
+		const TScriptInterface<IInteractableTarget> Interactable = Entry.GetInteractableTarget();
+		return IsNotIgnored(Entry) && !(Interactable && Interactable->IsMovingInteractable());
+	};
+
+	const FInteractableIndexEntry* ClosestEntry = nullptr;
+	double ClosestDistance = MAX_dbl;
+
+	for (const TPair<TObjectKey<ULevel>, TSharedPtr<FInteractableIndexCell>>& Cell : Cells)
+	{
+		double EntryDistance;
+		const FInteractableIndexEntry* Entry = Cell.Value->RaycastEntries(Start, End, CategoryFilter, IsStaticAndNotIgnored, EntryDistance);
+		if (Entry && EntryDistance < ClosestDistance)
+		{
+			ClosestEntry = Entry;
+			ClosestDistance = EntryDistance;
+		}
+	}
+
+	FInteractableIndexEntry ClosestMovedEntry;
+	bool bClosestEntryMoved = false;
+
+	const FVector Delta = End - Start;
+	const double Length = Delta.Size();
+	if (MovingInteractables.Num() > 0 && Length > UE_SMALL_NUMBER)
+	{
+		const FVector InvDirection = InteractableIndex::MakeInvRayDirection(Delta / Length);
+
+		for (const FMovingInteractable& Moving : MovingInteractables)
+		{
+			const USceneComponent* Component = Moving.Component.Get();
+			if (Component == nullptr || !Moving.Target.IsValid())
+			{
+				continue;
+			}
+
+			// Where the component moved since the entries were registered
+			const FTransform MovedBy = Moving.RegisteredTransform.Inverse() * Component->GetComponentTransform();
+
+			for (const FInteractableIndexEntry& Entry : Moving.Entries)
+			{
+				if (!CategoryFilter.Matches(Entry.CategoryMask) || !Entry.Bounds.IsValid || !IsNotIgnored(Entry))
+				{
+					continue;
+				}
+
+				const FBox MovedBounds = Entry.Bounds.TransformBy(MovedBy);
+
+				double EntryDistance;
+				if (InteractableIndex::IntersectRayBox(Start, InvDirection, FMath::Min(ClosestDistance, Length), MovedBounds, EntryDistance)
+					&& EntryDistance < ClosestDistance)
+				{
+					ClosestMovedEntry = Entry;
+					ClosestMovedEntry.Location = MovedBy.TransformPosition(Entry.Location);
+					ClosestMovedEntry.Bounds = MovedBounds;
+					ClosestDistance = EntryDistance;
+					bClosestEntryMoved = true;
+				}
+			}
+		}
+	}
+
+	if (ClosestEntry == nullptr && !bClosestEntryMoved)
+	{
+		return false;
+	}
+
+	OutEntry = bClosestEntryMoved ? ClosestMovedEntry : *ClosestEntry;
+	OutDistance = ClosestDistance;
+	return true;
+}
+
+bool UInteractableIndexSubsystem::IsLevelIndexed(const ULevel* Level) const
+{
+	return Cells.Contains(Level);
+}
+
+int32 UInteractableIndexSubsystem::RegisterObserver(
+	double Radius, FInteractableProximityChangedDelegate Delegate, const FInteractableCategoryFilter& CategoryFilter)
+{
+	const int32 ObserverId = NextObserverId++;
+
+	FObserver& Observer = Observers.Add(ObserverId);
+	Observer.Delegate = MoveTemp(Delegate);
+	Observer.Radius = Radius;
+	Observer.CategoryFilter = CategoryFilter;
+
+	return ObserverId;
+}
+
+void UInteractableIndexSubsystem::UnregisterObserver(int32 ObserverId)
+{
+	Observers.Remove(ObserverId);
+}
+
+void UInteractableIndexSubsystem::UpdateObserver(int32 ObserverId, const FVector& Location)
+{
+	FObserver* Observer = Observers.Find(ObserverId);
+	if (Observer == nullptr)
+	{
+		return;
+	}
+
+	// Small movements are ignored, the radius is only ever off by the tolerance
+	const double MoveTolerance = UInteractionCoreSettings::Get()->InteractableObserverMoveTolerance;
+	const bool bMoved = !Observer->bHasLocation || FVector::DistSquared(Observer->Location, Location) > MoveTolerance * MoveTolerance;
+
+	if (!bMoved && Observer->IndexRevision == IndexRevision)
+	{
+		return;
+	}
+
+	if (bMoved)
+	{
+		Observer->Location = Location;
+		Observer->bHasLocation = true;
+	}
+	Observer->IndexRevision = IndexRevision;
+
+	TArray<FInteractableIndexEntry> Entered;
+	TArray<FInteractableIndexEntryKey> Exited;
+
+	// Everything of cells that streamed out left the radius
+	for (auto It = Observer->CellStates.CreateIterator(); It; ++It)
+	{
+		if (!Cells.Contains(It->Key))
+		{
+			for (const TPair<FInteractableIndexEntryKey, FInteractableIndexEntry>& OldEntry : It->Value.Inside)
+			{
+				Exited.Add(OldEntry.Key);
+			}
+			It.RemoveCurrent();
+		}
+	}
+
+	const FVector Center = Observer->Location;
+	const double Radius = Observer->Radius;
+	const FInteractableCategoryFilter& CategoryFilter = Observer->CategoryFilter;
+
+	TMap<FInteractableIndexEntryKey, FInteractableIndexEntry> NewInside;
+	for (const TPair<TObjectKey<ULevel>, TSharedPtr<FInteractableIndexCell>>& CellPair : Cells)
+	{
+		const FInteractableIndexCell& Cell = *CellPair.Value;
+
+		FObserverCellState* CellState = Observer->CellStates.Find(CellPair.Key);
+		if (!bMoved && CellState && CellState->Revision == Cell.Revision)
+		{
+			continue;
+		}
+
+		const bool bInRange = Cell.Bounds.IsValid && FMath::SphereAABBIntersection(Center, Radius * Radius, Cell.Bounds);
+		if (!bInRange && CellState == nullptr)
+		{
+			continue;
+		}
+
+		NewInside.Reset();
+		if (bInRange)
+		{
+			Cell.ForEachEntryInSphere(Center, Radius, CategoryFilter, [&NewInside](const FInteractableIndexEntry& Entry)
+			{
+				if (Entry.Target.IsValid())
+				{
+					NewInside.Add(Entry.GetKey(), Entry);
+				}
+			});
+		}
+
+		if (CellState == nullptr)
+		{
+			CellState = &Observer->CellStates.Add(CellPair.Key);
+		}
+
+		for (const TPair<FInteractableIndexEntryKey, FInteractableIndexEntry>& OldEntry : CellState->Inside)
+		{
+			// Never rebuild the key from the entry, its target may be gone and the key wouldn't match anymore
+			if (!NewInside.Contains(OldEntry.Key))
+			{
+				Exited.Add(OldEntry.Key);
+			}
+		}
+
+		for (const TPair<FInteractableIndexEntryKey, FInteractableIndexEntry>& NewEntry : NewInside)
+		{
+			if (!CellState->Inside.Contains(NewEntry.Key))
+			{
+				Entered.Add(NewEntry.Value);
+			}
+		}
+
+		CellState->Revision = Cell.Revision;
+		Swap(CellState->Inside, NewInside);
+	}
+
+	if (Entered.Num() > 0 || Exited.Num() > 0)
+	{
+		// The delegate may unregister the observer, so don't touch it afterwards
+		Observer->Delegate.ExecuteIfBound(Entered, Exited);
+	}
+}
+
+void UInteractableIndexSubsystem::OnLevelAddedToWorld(ULevel* Level, UWorld* World)
+{
+	if (World == GetWorld() && Level)
+	{
+		QueueLevel(Level);
+	}
+}
+
+void UInteractableIndexSubsystem::OnLevelRemovedFromWorld(ULevel* Level, UWorld* World)
+{
+	if (World != GetWorld())
+	{
+		return;
+	}
+
+	// A null level means all levels were removed
+	if (Level == nullptr)
+	{
+		Cells.Reset();
+		PendingGathers.Reset();
+		PendingBuilds.Reset();
+		DeferredActors.Reset();
+		++IndexRevision;
+		return;
+	}
+
+	if (Cells.Remove(Level) > 0)
+	{
+		++IndexRevision;
+	}
+
+	MovingInteractables.RemoveAllSwap([Level](const FMovingInteractable& Moving)
+	{
+		const USceneComponent* Component = Moving.Component.Get();
+		return Component == nullptr || Component->GetComponentLevel() == Level;
+	});
+
+	PendingGathers.RemoveAll([Level](const FPendingGather& Gather)
+	{
+		return Gather.Cell->Level.Get() == Level;
+	});
+
+	// In-flight builds only touch their own cell, so they can be abandoned
+	PendingBuilds.RemoveAll([Level](const FPendingBuild& Build)
+	{
+		return Build.Cell->Level.Get() == Level;
+	});
+
+	DeferredActors.RemoveAll([Level](const TWeakObjectPtr<AActor>& Actor)
+	{
+		return !Actor.IsValid() || Actor->GetLevel() == Level;
+	});
+}
+
+void UInteractableIndexSubsystem::OnActorSpawned(AActor* Actor)
+{
+	const ULevel* Level = Actor ? Actor->GetLevel() : nullptr;
+	if (Level == nullptr)
+	{
+		return;
+	}
+
+	// Actors of pending levels are deferred until the level is published
+	if (Cells.Contains(Level) || IsLevelPending(Level))
+	{
+		RegisterActor(Actor);
+	}
+}
+
+void UInteractableIndexSubsystem::OnActorDestroyed(AActor* Actor)
+{
+	if (Actor)
+	{
+		UnregisterActor(Actor);
+	}
+}
+
+void UInteractableIndexSubsystem::QueueLevel(ULevel* Level)
+{
+	if (Cells.Contains(Level) || IsLevelPending(Level))
+	{
+		return;
+	}
+
+	const TSharedRef<FInteractableIndexCell> Cell = MakeShared<FInteractableIndexCell>();
+	Cell->Level = Level;
+
+	FPendingGather& Gather = PendingGathers.AddDefaulted_GetRef();
+	Gather.Cell = Cell;
+
+	// Cooked levels come with their static interactables baked, only the movable ones have to be gathered
+	if (FPlatformProperties::RequiresCookedData())
+	{
+		if (const UInteractableIndexLevelData* BakedData = Level->GetAssetUserData<UInteractableIndexLevelData>())
+		{
+			BakedData->AppendEntries(Cell->Entries);
+			Gather.BakedData = BakedData;
+		}
+	}
+}
+
+void UInteractableIndexSubsystem::ProcessPendingGathers()
+{
+	int32 RemainingBudget = UInteractionCoreSettings::Get()->MaxInteractableActorsGatheredPerFrame;
+
+	while (PendingGathers.Num() > 0 && RemainingBudget > 0)
+	{
+		FPendingGather& Gather = PendingGathers[0];
+		const ULevel* Level = Gather.Cell->Level.Get();
+		if (Level == nullptr)
+		{
+			PendingGathers.RemoveAt(0);
+			continue;
+		}
+
+		const UInteractableIndexLevelData* BakedData = Gather.BakedData.Get();
+		const TArray<TObjectPtr<AActor>>& Actors = BakedData ? BakedData->GetRuntimeActors() : Level->Actors;
+
+		const int32 NumActors = Actors.Num();
+		const int32 EndActorIndex = FMath::Min(NumActors, Gather.NextActorIndex + RemainingBudget);
+
+		for (int32 ActorIdx = Gather.NextActorIndex; ActorIdx < EndActorIndex; ++ActorIdx)
+		{
+			AActor* Actor = Actors[ActorIdx];
+			if (IsValid(Actor))
+			{
+				GatherEntriesForActor(Actor, Gather.Cell->Entries);
+			}
+		}
+
+		INC_DWORD_STAT_BY(STAT_InteractableActorsGathered, EndActorIndex - Gather.NextActorIndex);
+		RemainingBudget -= EndActorIndex - Gather.NextActorIndex;
+		Gather.NextActorIndex = EndActorIndex;
+
+		if (Gather.NextActorIndex < NumActors)
+		{
+			// Out of budget, continue next frame
+			break;
+		}
+
+		const TSharedRef<FInteractableIndexCell> Cell = Gather.Cell.ToSharedRef();
+		PendingGathers.RemoveAt(0);
+		BuildCell(Cell);
+	}
+}
+
+void UInteractableIndexSubsystem::ProcessPendingBuilds()
+{
+	for (int32 BuildIdx = PendingBuilds.Num() - 1; BuildIdx >= 0; --BuildIdx)
+	{
+		if (!PendingBuilds[BuildIdx].Task.IsCompleted())
+		{
+			continue;
+		}
+
+		const TSharedRef<FInteractableIndexCell> Cell = PendingBuilds[BuildIdx].Cell.ToSharedRef();
+		PendingBuilds.RemoveAtSwap(BuildIdx);
+		PublishCell(Cell);
+	}
+}
+
+void UInteractableIndexSubsystem::BuildCell(const TSharedRef<FInteractableIndexCell>& Cell)
+{
+	const UInteractionCoreSettings* Settings = UInteractionCoreSettings::Get();
+	const double GridCellSize = Settings->InteractableIndexGridCellSize;
+
+	if (!Settings->bBuildInteractableIndexCellsAsync)
+	{
+		Cell->BuildGrid(GridCellSize);
+		PublishCell(Cell);
+		return;
+	}
+
+	FPendingBuild& Build = PendingBuilds.AddDefaulted_GetRef();
+	Build.Cell = Cell;
+	Build.Task = UE::Tasks::Launch(UE_SOURCE_LOCATION, [Cell, GridCellSize]()
+	{
+		Cell->BuildGrid(GridCellSize);
+	});
+}
+
+void UInteractableIndexSubsystem::PublishCell(const TSharedRef<FInteractableIndexCell>& Cell)
+{
+	ULevel* Level = Cell->Level.Get();
+	if (Level == nullptr)
+	{
+		return;
+	}
+
+	Cells.Add(Level, Cell);
+	++IndexRevision;
+
+	// Register everything that changed while the cell wasn't queryable yet
+	for (int32 ActorIdx = DeferredActors.Num() - 1; ActorIdx >= 0; --ActorIdx)
+	{
+		AActor* Actor = DeferredActors[ActorIdx].Get();
+		if (Actor == nullptr || Actor->GetLevel() == Level)
+		{
+			DeferredActors.RemoveAtSwap(ActorIdx);
+			if (Actor)
+			{
+				RegisterActor(Actor);
+			}
+		}
+	}
+}
+
+bool UInteractableIndexSubsystem::IsLevelPending(const ULevel* Level) const
+{
+	return PendingGathers.ContainsByPredicate([Level](const FPendingGather& Gather) { return Gather.Cell->Level.Get() == Level; })
+		|| PendingBuilds.ContainsByPredicate([Level](const FPendingBuild& Build) { return Build.Cell->Level.Get() == Level; });
+}
+
+void UInteractableIndexSubsystem::GatherEntriesForActor(AActor* Actor, TArray<FInteractableIndexEntry>& OutEntries)
+{
+	TArray<TScriptInterface<IInteractableTarget>> InteractableTargets;
+	UInteractionStatics::GetInteractableTargetsFromActor(Actor, InteractableTargets);
+
+	for (const TScriptInterface<IInteractableTarget>& InteractableTarget : InteractableTargets)
+	{
+		const int32 FirstEntryIdx = OutEntries.Num();
+		InteractableTarget->GatherInteractableIndexEntries(OutEntries);
+		TrackMovingInteractable(InteractableTarget, TConstArrayView<FInteractableIndexEntry>(OutEntries).RightChop(FirstEntryIdx));
+	}
+}
+
+void UInteractableIndexSubsystem::TrackMovingInteractable(
+	const TScriptInterface<IInteractableTarget>& Interactable, TConstArrayView<FInteractableIndexEntry> Entries)
+{
+	if (!Interactable || !Interactable->IsMovingInteractable())
+	{
+		return;
+	}
+
+	UObject* Target = Interactable.GetObject();
+	FMovingInteractable* Moving = MovingInteractables.FindByPredicate([Target](const FMovingInteractable& Other) { return Other.Target.Get() == Target; });
+
+	if (Moving == nullptr)
+	{
+		USceneComponent* Component = Cast<USceneComponent>(Target);
+		if (Component == nullptr)
+		{
+			const AActor* Actor = UInteractionStatics::GetActorFromInteractableTarget(Interactable);
+			Component = Actor ? Actor->GetRootComponent() : nullptr;
+		}
+
+		if (Component == nullptr)
+		{
+			return;
+		}
+
+		Moving = &MovingInteractables.AddDefaulted_GetRef();
+		Moving->Target = Target;
+		Moving->Component = Component;
+		Moving->Samples.Reserve(UInteractionCoreSettings::Get()->InteractableHistorySize);
+	}
+
+	// Entries are moved along with the component, relative to where they were registered
+	Moving->Entries = Entries;
+	Moving->IndexedLocations.Reset(Entries.Num());
+	for (const FInteractableIndexEntry& Entry : Entries)
+	{
+		Moving->IndexedLocations.Add(Entry.Location);
+	}
+
+	if (const USceneComponent* Component = Moving->Component.Get())
+	{
+		Moving->RegisteredTransform = Component->GetComponentTransform();
+		Moving->IndexedTransform = Moving->RegisteredTransform;
+	}
+}
+
+void UInteractableIndexSubsystem::RecordMovingInteractables()
+{
+	if (MovingInteractables.Num() == 0)
+	{
+		return;
+	}
+
+	const UInteractionCoreSettings* Settings = UInteractionCoreSettings::Get();
+	const double Now = GetHistoryTime();
+	if (Now - LastHistorySampleTime < Settings->InteractableHistorySampleInterval)
+	{
+		return;
+	}
+
+	LastHistorySampleTime = Now;
+
+	// One pass over all moving interactables, instead of every one of them ticking on its own
+	const int32 HistorySize = FMath::Max(Settings->InteractableHistorySize, 2);
+	const double MoveToleranceSquared = FMath::Square(Settings->InteractableObserverMoveTolerance);
+	bool bMovedEntries = false;
+
+	for (int32 MovingIdx = MovingInteractables.Num() - 1; MovingIdx >= 0; --MovingIdx)
+	{
+		FMovingInteractable& Moving = MovingInteractables[MovingIdx];
+		const USceneComponent* Component = Moving.Component.Get();
+		if (Component == nullptr || !Moving.Target.IsValid())
+		{
+			MovingInteractables.RemoveAtSwap(MovingIdx, 1, EAllowShrinking::No);
+			continue;
+		}
+
+		FTransformSample Sample;
+		Sample.Time = Now;
+		Sample.Transform = Component->GetComponentTransform();
+
+		if (Moving.Samples.Num() < HistorySize)
+		{
+			Moving.Samples.Add(Sample);
+			Moving.NextSampleIndex = Moving.Samples.Num() % HistorySize;
+		}
+		else
+		{
+			Moving.Samples[Moving.NextSampleIndex] = Sample;
+			Moving.NextSampleIndex = (Moving.NextSampleIndex + 1) % Moving.Samples.Num();
+		}
+
+		// Move the index entries along, so sphere, nearest and observer queries see the interactable where it is
+		const bool bMoved = FVector::DistSquared(Sample.Transform.GetLocation(), Moving.IndexedTransform.GetLocation()) > MoveToleranceSquared
+			|| !Sample.Transform.GetRotation().Equals(Moving.IndexedTransform.GetRotation())
+			|| !Sample.Transform.GetScale3D().Equals(Moving.IndexedTransform.GetScale3D());
+
+		const ULevel* Level = Component->GetOwner() ? Component->GetOwner()->GetLevel() : nullptr;
+		const TSharedPtr<FInteractableIndexCell>* Cell = bMoved && Level ? Cells.Find(Level) : nullptr;
+		if (Cell == nullptr)
+		{
+			continue;
+		}
+
+		const FTransform MovedBy = Moving.RegisteredTransform.Inverse() * Sample.Transform;
+		for (int32 EntryIdx = 0; EntryIdx < Moving.Entries.Num(); ++EntryIdx)
+		{
+			const FInteractableIndexEntry& Entry = Moving.Entries[EntryIdx];
+			const FVector NewLocation = MovedBy.TransformPosition(Entry.Location);
+			const FBox NewBounds = Entry.Bounds.IsValid ? Entry.Bounds.TransformBy(MovedBy) : FBox(ForceInit);
+
+			if ((*Cell)->MoveEntry(Entry.GetKey(), Moving.IndexedLocations[EntryIdx], NewLocation, NewBounds))
+			{
+				Moving.IndexedLocations[EntryIdx] = NewLocation;
+				bMovedEntries = true;
+			}
+		}
+
+		Moving.IndexedTransform = Sample.Transform;
+	}
+
+	if (bMovedEntries)
+	{
+		++IndexRevision;
+	}
+}
+
+double UInteractableIndexSubsystem::GetHistoryTime() const
+{
+	const UWorld* World = GetWorld();
+	const AGameStateBase* GameState = World ? World->GetGameState() : nullptr;
+	return GameState ? GameState->GetServerWorldTimeSeconds() : (World ? World->GetTimeSeconds() : 0.0);
+}
+
+bool UInteractableIndexSubsystem::GetInteractableTransformAtTime(const UObject* Target, double Time, FTransform& OutTransform) const
+{
+	const FMovingInteractable* Moving = MovingInteractables.FindByPredicate([Target](const FMovingInteractable& Moving)
+	{
+		return Moving.Target.Get() == Target;
+	});
+
+	const USceneComponent* Component = Moving ? Moving->Component.Get() : nullptr;
+	if (Component == nullptr)
+	{
+		return false;
+	}
+
+	// Newer than anything recorded, so it's where the target is now
+	if (Moving->Samples.Num() == 0 || Time >= Moving->GetSample(0).Time)
+	{
+		OutTransform = Component->GetComponentTransform();
+		return true;
+	}
+
+	for (int32 Age = 1; Age < Moving->Samples.Num(); ++Age)
+	{
+		const FTransformSample& Older = Moving->GetSample(Age);
+		if (Older.Time <= Time)
+		{
+			const FTransformSample& Newer = Moving->GetSample(Age - 1);
+			const double Alpha = Newer.Time > Older.Time ? (Time - Older.Time) / (Newer.Time - Older.Time) : 1.0;
+
+			OutTransform.Blend(Older.Transform, Newer.Transform, float(Alpha));
+			return true;
+		}
+	}
+
+	// Older than the history reaches back
+	OutTransform = Moving->GetSample(Moving->Samples.Num() - 1).Transform;
+	return true;
+}
+
+bool UInteractableIndexSubsystem::ValidateInteraction(
+	const AActor* Instigator, const UObject* Target, int32 InstanceIndex, double Time, float MaxRange, bool bCheckLineOfSight) const
+{
+	if (Instigator == nullptr || Target == nullptr)
+	{
+		return false;
+	}
+
+	const FVector InstigatorLocation = Instigator->GetActorLocation();
+	const AActor* TargetActor = UInteractionStatics::GetActorFromInteractableTarget(TScriptInterface<IInteractableTarget>(const_cast<UObject*>(Target)));
+
+	// Never trust the client further back than the rewind window
+	const double Now = GetHistoryTime();
+	Time = FMath::Clamp(Time, Now - UInteractionCoreSettings::Get()->MaxInteractionRewindTime, Now);
+
+	FBox TargetBounds(ForceInit);
+
+	FTransform RewoundTransform;
+	const FMovingInteractable* Moving = MovingInteractables.FindByPredicate([Target](const FMovingInteractable& Moving) { return Moving.Target.Get() == Target; });
+	const USceneComponent* MovingComponent = Moving ? Moving->Component.Get() : nullptr;
+	if (MovingComponent && GetInteractableTransformAtTime(Target, Time, RewoundTransform))
+	{
+		// Only the translation is rewound, the bounds of a rotating target are good enough for range checks
+		const FBox CurrentBounds = TargetActor ? TargetActor->GetComponentsBoundingBox() : MovingComponent->Bounds.GetBox();
+		TargetBounds = CurrentBounds.ShiftBy(RewoundTransform.GetLocation() - MovingComponent->GetComponentLocation());
+	}
+	else
+	{
+		// Targets that don't move are validated against the bounds the scans found them with
+		FInteractableIndexEntry Entry;
+		if (FindInteractable(FInteractableIndexEntryKey(Target, InstanceIndex), InstigatorLocation, MaxRange, Entry))
+		{
+			TargetBounds = Entry.Bounds.IsValid ? Entry.Bounds : FBox(Entry.Location, Entry.Location);
+		}
+		else if (TargetActor)
+		{
+			TargetBounds = FBox(TargetActor->GetActorLocation(), TargetActor->GetActorLocation());
+		}
+	}
+
+	if (!TargetBounds.IsValid || TargetBounds.ComputeSquaredDistanceToPoint(InstigatorLocation) > FMath::Square(MaxRange))
+	{
+		INC_DWORD_STAT(STAT_InteractionValidationsRejected);
+		return false;
+	}
+
+	if (bCheckLineOfSight)
+	{
+		FVector EyesLocation;
+		FRotator EyesRotation;
+		Instigator->GetActorEyesViewPoint(EyesLocation, EyesRotation);
+
+		// The target isn't where it was, so it can't block the trace to where it was
+		FCollisionQueryParams Params(SCENE_QUERY_STAT(ValidateInteraction), false, Instigator);
+		Params.AddIgnoredActor(TargetActor);
+
+		INC_DWORD_STAT(STAT_InteractionTraces);
+		if (GetWorld()->LineTraceTestByChannel(EyesLocation, TargetBounds.GetClosestPointTo(EyesLocation), ECC_Visibility, Params))
+		{
+			INC_DWORD_STAT(STAT_InteractionValidationsRejected);
+			return false;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,484 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+
+#include "InteractableIndexTypes.h"
+
+#include "Interfaces/IInteractableTarget.h"
+#include "Math/VectorRegister.h"
+#include "Misc/ScopeRWLock.h"
+
+//////////////////////////////////////////////////////////////////////////
+/// FInteractableIndexEntry
+
+TScriptInterface<IInteractableTarget> FInteractableIndexEntry::GetInteractableTarget() const
+{
+	return TScriptInterface<IInteractableTarget>(Target.Get());
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// InteractableIndex
+
+bool InteractableIndex::IntersectRayBox(const FVector& Origin, const FVector& InvDirection, double MaxDistance, const FBox& Box, double& OutDistance)
+{
+	const VectorRegister4Double RayOrigin = VectorLoadFloat3(&Origin.X);
+	const VectorRegister4Double RayInvDirection = VectorLoadFloat3(&InvDirection.X);
+
+	// Distances along the ray to the min and max planes of every axis
+	const VectorRegister4Double ToMin = VectorMultiply(VectorSubtract(VectorLoadFloat3(&Box.Min.X), RayOrigin), RayInvDirection);
+	const VectorRegister4Double ToMax = VectorMultiply(VectorSubtract(VectorLoadFloat3(&Box.Max.X), RayOrigin), RayInvDirection);
+
+	double Enter[4];
+	double Exit[4];
+	VectorStore(VectorMin(ToMin, ToMax), Enter);
+	VectorStore(VectorMax(ToMin, ToMax), Exit);
+
+	const double EnterDistance = FMath::Max(FMath::Max3(Enter[0], Enter[1], Enter[2]), 0.0);
+	const double ExitDistance = FMath::Min(FMath::Min3(Exit[0], Exit[1], Exit[2]), MaxDistance);
+
+	if (EnterDistance > ExitDistance)
+	{
+		return false;
+	}
+
+	OutDistance = EnterDistance;
+	return true;
+}
+
+FVector InteractableIndex::MakeInvRayDirection(const FVector& Direction)
+{
+	// Axis parallel rays would divide by zero, a tiny direction keeps the slab test well defined
+	return FVector(
+		1.0 / (FMath::Abs(Direction.X) > UE_SMALL_NUMBER ? Direction.X : UE_SMALL_NUMBER),
+		1.0 / (FMath::Abs(Direction.Y) > UE_SMALL_NUMBER ? Direction.Y : UE_SMALL_NUMBER),
+		1.0 / (FMath::Abs(Direction.Z) > UE_SMALL_NUMBER ? Direction.Z : UE_SMALL_NUMBER));
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// FInteractableIndexCell
+
+void FInteractableIndexCell::BuildGrid(double InGridCellSize)
+{
+	FWriteScopeLock WriteLock(Lock);
+
+	GridCellSize = FMath::Max(InGridCellSize, 1.0);
+
+	// Drop entries that were removed since the last build
+	Entries.RemoveAllSwap([](const FInteractableIndexEntry& Entry)
+	{
+		return Entry.Target.IsExplicitlyNull();
+	});
+
+	Grid.Reset();
+	Bounds = FBox(ForceInit);
+	MaxEntryExtent = 0.0;
+
+	for (int32 EntryIdx = 0; EntryIdx < Entries.Num(); ++EntryIdx)
+	{
+		const FInteractableIndexEntry& Entry = Entries[EntryIdx];
+		Grid.FindOrAdd(GetGridCoord(Entry.Location)).Add(EntryIdx);
+
+		Bounds += Entry.Bounds.IsValid ? Entry.Bounds : FBox(Entry.Location, Entry.Location);
+		MaxEntryExtent = FMath::Max(MaxEntryExtent, Entry.Bounds.IsValid ? Entry.Bounds.GetExtent().GetMax() : 0.0);
+	}
+
+	NumRemovedEntries = 0;
+	++Revision;
+}
+
+void FInteractableIndexCell::AddEntry(const FInteractableIndexEntry& Entry)
+{
+	FWriteScopeLock WriteLock(Lock);
+
+	const int32 EntryIdx = Entries.Add(Entry);
+	Grid.FindOrAdd(GetGridCoord(Entry.Location)).Add(EntryIdx);
+
+	Bounds += Entry.Bounds.IsValid ? Entry.Bounds : FBox(Entry.Location, Entry.Location);
+	MaxEntryExtent = FMath::Max(MaxEntryExtent, Entry.Bounds.IsValid ? Entry.Bounds.GetExtent().GetMax() : 0.0);
+	++Revision;
+}
+
+int32 FInteractableIndexCell::RemoveEntriesForTarget(const UObject* Target)
+{
+	return RemoveEntriesMatching([Target](const FInteractableIndexEntry& Entry)
+	{
+		return Entry.Target.Get() == Target;
+	});
+}
+
+bool FInteractableIndexCell::RemoveEntry(const FInteractableIndexEntryKey& Key)
+{
+	return RemoveEntriesMatching([&Key](const FInteractableIndexEntry& Entry)
+	{
+		return Entry.InstanceIndex == Key.InstanceIndex && FObjectKey(Entry.Target.Get()) == Key.Target;
+	}) > 0;
+}
+
+bool FInteractableIndexCell::MoveEntry(const FInteractableIndexEntryKey& Key, const FVector& OldLocation, const FVector& NewLocation, const FBox& NewBounds)
+{
+	FWriteScopeLock WriteLock(Lock);
+
+	TArray<int32>* OldBucket = Grid.Find(GetGridCoord(OldLocation));
+	if (OldBucket == nullptr)
+	{
+		return false;
+	}
+
+	const int32 BucketIdx = OldBucket->IndexOfByPredicate([this, &Key](const int32 EntryIdx)
+	{
+		const FInteractableIndexEntry& Entry = Entries[EntryIdx];
+		return Entry.InstanceIndex == Key.InstanceIndex && FObjectKey(Entry.Target.Get()) == Key.Target;
+	});
+
+	if (BucketIdx == INDEX_NONE)
+	{
+		return false;
+	}
+
+	const int32 EntryIdx = (*OldBucket)[BucketIdx];
+	FInteractableIndexEntry& Entry = Entries[EntryIdx];
+	Entry.Location = NewLocation;
+	Entry.Bounds = NewBounds;
+
+	const FIntVector NewCoord = GetGridCoord(NewLocation);
+	if (NewCoord != GetGridCoord(OldLocation))
+	{
+		OldBucket->RemoveAtSwap(BucketIdx);
+		Grid.FindOrAdd(NewCoord).Add(EntryIdx);
+	}
+
+	// The bounds only ever grow until the grid is rebuilt, which is fine for culling
+	Bounds += NewBounds.IsValid ? NewBounds : FBox(NewLocation, NewLocation);
+	MaxEntryExtent = FMath::Max(MaxEntryExtent, NewBounds.IsValid ? NewBounds.GetExtent().GetMax() : 0.0);
+	++Revision;
+	return true;
+}
+
+int32 FInteractableIndexCell::RemoveEntriesMatching(TFunctionRef<bool(const FInteractableIndexEntry&)> Predicate)
+{
+	int32 NumRemoved = 0;
+	{
+		FWriteScopeLock WriteLock(Lock);
+
+		for (int32 EntryIdx = 0; EntryIdx < Entries.Num(); ++EntryIdx)
+		{
+			FInteractableIndexEntry& Entry = Entries[EntryIdx];
+			if (Entry.Target.IsExplicitlyNull() || !Predicate(Entry))
+			{
+				continue;
+			}
+
+			// Keep the entry around as a tombstone, so the indices in the grid stay valid
+			if (TArray<int32>* Bucket = Grid.Find(GetGridCoord(Entry.Location)))
+			{
+				Bucket->RemoveSingleSwap(EntryIdx);
+			}
+
+			Entry.Target.Reset();
+			++NumRemoved;
+		}
+
+		if (NumRemoved == 0)
+		{
+			return 0;
+		}
+
+		NumRemovedEntries += NumRemoved;
+		++Revision;
+	}
+
+	// Compact once the tombstones make up a good part of the cell, building the grid takes the lock itself
+	if (NumRemovedEntries > 0 && NumRemovedEntries * 2 > Entries.Num())
+	{
+		BuildGrid(GridCellSize);
+	}
+
+	return NumRemoved;
+}
+
+void FInteractableIndexCell::CopyEntriesInSphere(
+	const FVector& Center, double Radius, const FInteractableCategoryFilter& CategoryFilter, TArray<FInteractableIndexEntry>& OutEntries) const
+{
+	// Entries are copied without resolving their targets, so this never touches any UObject
+	FReadScopeLock ReadLock(Lock);
+
+	ForEachEntryInSphere(Center, Radius, CategoryFilter, [&OutEntries](const FInteractableIndexEntry& Entry)
+	{
+		OutEntries.Add(Entry);
+	});
+}
+
+void FInteractableIndexCell::ForEachEntryInSphere(
+	const FVector& Center, double Radius, const FInteractableCategoryFilter& CategoryFilter, TFunctionRef<void(const FInteractableIndexEntry&)> Func) const
+{
+	if (Entries.Num() == 0 || !Bounds.IsValid)
+	{
+		return;
+	}
+
+	const double RadiusSquared = Radius * Radius;
+	if (!FMath::SphereAABBIntersection(Center, RadiusSquared, Bounds))
+	{
+		return;
+	}
+
+	// Entries are bucketed by their location, so pad the search by the largest entry extent
+	const FVector Padding(Radius + MaxEntryExtent);
+	const FIntVector MinCoord = GetGridCoord(Center - Padding);
+	const FIntVector MaxCoord = GetGridCoord(Center + Padding);
+
+	for (int32 X = MinCoord.X; X <= MaxCoord.X; ++X)
+	{
+		for (int32 Y = MinCoord.Y; Y <= MaxCoord.Y; ++Y)
+		{
+			for (int32 Z = MinCoord.Z; Z <= MaxCoord.Z; ++Z)
+			{
+				const TArray<int32>* Bucket = Grid.Find(FIntVector(X, Y, Z));
+				if (Bucket == nullptr)
+				{
+					continue;
+				}
+
+				for (const int32 EntryIdx : *Bucket)
+				{
+					const FInteractableIndexEntry& Entry = Entries[EntryIdx];
+					if (!CategoryFilter.Matches(Entry.CategoryMask))
+					{
+						continue;
+					}
+
+					const FBox EntryBounds = Entry.Bounds.IsValid ? Entry.Bounds : FBox(Entry.Location, Entry.Location);
+					if (FMath::SphereAABBIntersection(Center, RadiusSquared, EntryBounds))
+					{
+						Func(Entry);
+					}
+				}
+			}
+		}
+	}
+}
+
+void FInteractableIndexCell::FindNearestEntries(
+	const FVector& Center, double MaxDistance, int32 MaxCount, const FInteractableCategoryFilter& CategoryFilter,
+	TArray<TPair<double, const FInteractableIndexEntry*>>& InOutHeap) const
+{
+	if (Entries.Num() == 0 || !Bounds.IsValid || MaxCount <= 0)
+	{
+		return;
+	}
+
+	const double MaxDistanceSquared = MaxDistance * MaxDistance;
+	if (Bounds.ComputeSquaredDistanceToPoint(Center) > MaxDistanceSquared)
+	{
+		return;
+	}
+
+	// Farthest entry on top, so it's the one to replace
+	const auto HeapPredicate = [](const TPair<double, const FInteractableIndexEntry*>& A, const TPair<double, const FInteractableIndexEntry*>& B)
+	{
+		return A.Key > B.Key;
+	};
+
+	const FIntVector CenterCoord = GetGridCoord(Center);
+	const FIntVector MinCoord = GetGridCoord(Bounds.Min);
+	const FIntVector MaxCoord = GetGridCoord(Bounds.Max);
+
+	// No ring beyond this one can contain any of our entries
+	const int32 MaxRing = FMath::Max3(
+		FMath::Max(FMath::Abs(MinCoord.X - CenterCoord.X), FMath::Abs(MaxCoord.X - CenterCoord.X)),
+		FMath::Max(FMath::Abs(MinCoord.Y - CenterCoord.Y), FMath::Abs(MaxCoord.Y - CenterCoord.Y)),
+		FMath::Max(FMath::Abs(MinCoord.Z - CenterCoord.Z), FMath::Abs(MaxCoord.Z - CenterCoord.Z)));
+
+	const auto VisitBucket = [&](const FIntVector& Coord)
+	{
+		const TArray<int32>* Bucket = Grid.Find(Coord);
+		if (Bucket == nullptr)
+		{
+			return;
+		}
+
+		for (const int32 EntryIdx : *Bucket)
+		{
+			const FInteractableIndexEntry& Entry = Entries[EntryIdx];
+			if (!CategoryFilter.Matches(Entry.CategoryMask))
+			{
+				continue;
+			}
+
+			const double DistanceSquared = FVector::DistSquared(Center, Entry.Location);
+			if (DistanceSquared > MaxDistanceSquared || !Entry.Target.IsValid())
+			{
+				continue;
+			}
+
+			if (InOutHeap.Num() < MaxCount)
+			{
+				InOutHeap.HeapPush(TPair<double, const FInteractableIndexEntry*>(DistanceSquared, &Entry), HeapPredicate);
+			}
+			else if (DistanceSquared < InOutHeap.HeapTop().Key)
+			{
+				InOutHeap.HeapPopDiscard(HeapPredicate, EAllowShrinking::No);
+				InOutHeap.HeapPush(TPair<double, const FInteractableIndexEntry*>(DistanceSquared, &Entry), HeapPredicate);
+			}
+		}
+	};
+
+	for (int32 Ring = 0; Ring <= MaxRing; ++Ring)
+	{
+		// Entries of this ring are at least this far away, so once the heap is full of closer entries we're done
+		const double RingDistance = FMath::Max(Ring - 1, 0) * GridCellSize;
+		if (RingDistance > MaxDistance || (InOutHeap.Num() >= MaxCount && RingDistance * RingDistance >= InOutHeap.HeapTop().Key))
+		{
+			break;
+		}
+
+		// Only the shell of the ring, the inside was visited by the previous rings
+		for (int32 X = -Ring; X <= Ring; ++X)
+		{
+			for (int32 Y = -Ring; Y <= Ring; ++Y)
+			{
+				const bool bOnShell = FMath::Abs(X) == Ring || FMath::Abs(Y) == Ring;
+				for (int32 Z = -Ring; Z <= Ring; Z += (bOnShell || Ring == 0) ? 1 : 2 * Ring)
+				{
+					VisitBucket(CenterCoord + FIntVector(X, Y, Z));
+				}
+			}
+		}
+	}
+}
+
+const FInteractableIndexEntry* FInteractableIndexCell::RaycastEntries(
+	const FVector& Start, const FVector& End, const FInteractableCategoryFilter& CategoryFilter,
+	TFunctionRef<bool(const FInteractableIndexEntry&)> Predicate, double& OutDistance) const
+{
+	if (Entries.Num() == 0 || !Bounds.IsValid)
+	{
+		return nullptr;
+	}
+
+	const FVector Delta = End - Start;
+	const double Length = Delta.Size();
+	if (Length <= UE_SMALL_NUMBER)
+	{
+		return nullptr;
+	}
+
+	const FVector Direction = Delta / Length;
+	const FVector InvDirection = InteractableIndex::MakeInvRayDirection(Direction);
+
+	double CellDistance;
+	if (!InteractableIndex::IntersectRayBox(Start, InvDirection, Length, Bounds, CellDistance))
+	{
+		return nullptr;
+	}
+
+	const FInteractableIndexEntry* ClosestEntry = nullptr;
+	double ClosestDistance = Length;
+
+	const auto VisitBucket = [&](const FIntVector& Coord)
+	{
+		const TArray<int32>* Bucket = Grid.Find(Coord);
+		if (Bucket == nullptr)
+		{
+			return;
+		}
+
+		for (const int32 EntryIdx : *Bucket)
+		{
+			const FInteractableIndexEntry& Entry = Entries[EntryIdx];
+
+			double EntryDistance;
+			if (CategoryFilter.Matches(Entry.CategoryMask) && Entry.Bounds.IsValid && Entry.Target.IsValid()
+				&& InteractableIndex::IntersectRayBox(Start, InvDirection, ClosestDistance, Entry.Bounds, EntryDistance)
+				&& (ClosestEntry == nullptr || EntryDistance < ClosestDistance)
+				&& Predicate(Entry))
+			{
+				ClosestEntry = &Entry;
+				ClosestDistance = EntryDistance;
+			}
+		}
+	};
+
+	// Entries are bucketed by their location, so the bounds of an entry can reach this many grid cells beyond its bucket
+	const int32 PaddingCells = FMath::CeilToInt32(MaxEntryExtent / GridCellSize);
+	TSet<FIntVector, DefaultKeyFuncs<FIntVector>, TInlineSetAllocator<64>> VisitedCoords;
+
+	// No cell outside of the bounds of all entries can contain a hit
+	const FIntVector MinCoord = GetGridCoord(Bounds.Min);
+	const FIntVector MaxCoord = GetGridCoord(Bounds.Max);
+
+	// Walk the grid along the segment (Amanatides & Woo), starting where it enters the bounds of all entries
+	const FVector WalkStart = Start + Direction * CellDistance;
+	FIntVector Coord = GetGridCoord(WalkStart);
+	Coord.X = FMath::Clamp(Coord.X, MinCoord.X, MaxCoord.X);
+	Coord.Y = FMath::Clamp(Coord.Y, MinCoord.Y, MaxCoord.Y);
+	Coord.Z = FMath::Clamp(Coord.Z, MinCoord.Z, MaxCoord.Z);
+
+	FIntVector Step;
+	FVector NextBoundaryDistance;
+	FVector BoundaryDistanceStep;
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		if (FMath::Abs(Direction[Axis]) <= UE_SMALL_NUMBER)
+		{
+			Step[Axis] = 0;
+			NextBoundaryDistance[Axis] = UE_BIG_NUMBER;
+			BoundaryDistanceStep[Axis] = 0.0;
+			continue;
+		}
+
+		Step[Axis] = Direction[Axis] > 0.0 ? 1 : -1;
+		const double Boundary = (Coord[Axis] + (Step[Axis] > 0 ? 1 : 0)) * GridCellSize;
+		NextBoundaryDistance[Axis] = CellDistance + (Boundary - WalkStart[Axis]) * InvDirection[Axis];
+		BoundaryDistanceStep[Axis] = GridCellSize * FMath::Abs(InvDirection[Axis]);
+	}
+
+	// A hit at some distance lies within the padding of the grid cell the segment is in at that distance, so once
+	// the segment enters a cell beyond the closest hit nothing closer can be found
+	double CellEnterDistance = CellDistance;
+	while (CellEnterDistance <= ClosestDistance
+		&& Coord.X >= MinCoord.X && Coord.X <= MaxCoord.X
+		&& Coord.Y >= MinCoord.Y && Coord.Y <= MaxCoord.Y
+		&& Coord.Z >= MinCoord.Z && Coord.Z <= MaxCoord.Z)
+	{
+		if (PaddingCells == 0)
+		{
+			VisitBucket(Coord);
+		}
+		else
+		{
+			for (int32 X = -PaddingCells; X <= PaddingCells; ++X)
+			{
+				for (int32 Y = -PaddingCells; Y <= PaddingCells; ++Y)
+				{
+					for (int32 Z = -PaddingCells; Z <= PaddingCells; ++Z)
+					{
+						bool bAlreadyVisited;
+						const FIntVector PaddedCoord = Coord + FIntVector(X, Y, Z);
+						VisitedCoords.Add(PaddedCoord, &bAlreadyVisited);
+						if (!bAlreadyVisited)
+						{
+							VisitBucket(PaddedCoord);
+						}
+					}
+				}
+			}
+		}
+
+		// Step into the neighbor whose boundary the segment crosses first
+		const int32 Axis = NextBoundaryDistance.X < NextBoundaryDistance.Y
+			? (NextBoundaryDistance.X < NextBoundaryDistance.Z ? 0 : 2)
+			: (NextBoundaryDistance.Y < NextBoundaryDistance.Z ? 1 : 2);
+
+		if (Step[Axis] == 0)
+		{
+			break;
+		}
+
+		CellEnterDistance = NextBoundaryDistance[Axis];
+		NextBoundaryDistance[Axis] += BoundaryDistanceStep[Axis];
+		Coord[Axis] += Step[Axis];
+	}
+
+	OutDistance = ClosestDistance;
+	return ClosestEntry;
+}
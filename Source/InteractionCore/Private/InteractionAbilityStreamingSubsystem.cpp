@@ -0,0 +1,97 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+
+#include "InteractionAbilityStreamingSubsystem.h"
+
+#include "Abilities/GameplayAbility.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "Engine/World.h"
+#include "InteractionCoreStats.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(InteractionAbilityStreamingSubsystem)
+
+UInteractionAbilityStreamingSubsystem::UInteractionAbilityStreamingSubsystem()
+{
+}
+
+UInteractionAbilityStreamingSubsystem* UInteractionAbilityStreamingSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+	return World ? UWorld::GetSubsystem<UInteractionAbilityStreamingSubsystem>(World) : nullptr;
+}
+
+void UInteractionAbilityStreamingSubsystem::Deinitialize()
+{
+	for (const TPair<FSoftObjectPath, TSharedPtr<FStreamableHandle>>& PendingLoad : PendingLoads)
+	{
+		if (PendingLoad.Value.IsValid())
+		{
+			PendingLoad.Value->CancelHandle();
+		}
+	}
+	PendingLoads.Reset();
+
+	StreamedAbilityClasses.Reset();
+	OnAbilityClassStreamed.Clear();
+
+	Super::Deinitialize();
+}
+
+bool UInteractionAbilityStreamingSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TSubclassOf<UGameplayAbility> UInteractionAbilityStreamingSubsystem::RequestAbilityClass(const TSoftClassPtr<UGameplayAbility>& AbilityClass)
+{
+	if (AbilityClass.IsNull())
+	{
+		return nullptr;
+	}
+
+	// Already loaded, possibly by someone else
+	if (UClass* LoadedClass = AbilityClass.Get())
+	{
+		return LoadedClass;
+	}
+
+	const FSoftObjectPath AbilityClassPath = AbilityClass.ToSoftObjectPath();
+	if (PendingLoads.Contains(AbilityClassPath))
+	{
+		return nullptr;
+	}
+
+	INC_DWORD_STAT(STAT_InteractionAbilitiesStreamed);
+
+	TSharedPtr<FStreamableHandle> Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+		AbilityClassPath,
+		FStreamableDelegate::CreateUObject(this, &ThisClass::HandleAbilityClassStreamed, AbilityClass));
+
+	// The delegate already ran if the load completed right away
+	if (Handle.IsValid() && !Handle->HasLoadCompleted())
+	{
+		PendingLoads.Add(AbilityClassPath, Handle);
+	}
+
+	return AbilityClass.Get();
+}
+
+bool UInteractionAbilityStreamingSubsystem::IsStreamingAbilityClass(const TSoftClassPtr<UGameplayAbility>& AbilityClass) const
+{
+	return PendingLoads.Contains(AbilityClass.ToSoftObjectPath());
+}
+
+void UInteractionAbilityStreamingSubsystem::HandleAbilityClassStreamed(TSoftClassPtr<UGameplayAbility> AbilityClass)
+{
+	PendingLoads.Remove(AbilityClass.ToSoftObjectPath());
+
+	TSubclassOf<UGameplayAbility> LoadedClass = AbilityClass.Get();
+	if (LoadedClass == nullptr)
+	{
+		return;
+	}
+
+	StreamedAbilityClasses.AddUnique(LoadedClass);
+	OnAbilityClassStreamed.Broadcast(AbilityClass);
+}
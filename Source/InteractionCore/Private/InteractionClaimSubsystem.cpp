@@ -0,0 +1,238 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+
+#include "InteractionClaimSubsystem.h"
+
+#include "Containers/HashTable.h"
+#include "Engine/World.h"
+#include "InteractionCoreSettings.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(InteractionClaimSubsystem)
+
+namespace InteractionClaims
+{
+	/** Builds the table key of an interactable, the top bit keeps it from ever being 0 */
+	static uint64 MakeTargetKey(const UObject* Target, int32 InstanceIndex)
+	{
+		return (uint64(1) << 63) | (uint64(Target->GetUniqueID()) << 32) | uint32(InstanceIndex + 1);
+	}
+
+	static uint64 MakeClaimWord(uint32 ClaimantId, uint32 ExpireTime)
+	{
+		return (uint64(ClaimantId) << 32) | ExpireTime;
+	}
+
+	static uint32 GetClaimantId(uint64 ClaimWord)
+	{
+		return uint32(ClaimWord >> 32);
+	}
+
+	/** Whether the claim word holds a claim that didn't expire yet */
+	static bool IsClaimActive(uint64 ClaimWord, uint32 Now)
+	{
+		return ClaimWord != 0 && uint32(ClaimWord) > Now;
+	}
+
+	/** Claim times are world times in hundredths of a second */
+	static uint32 ToClaimTime(double WorldTime)
+	{
+		return uint32(FMath::Clamp(WorldTime * 100.0, 0.0, double(MAX_uint32)));
+	}
+}
+
+UInteractionClaimSubsystem::UInteractionClaimSubsystem()
+{
+}
+
+UInteractionClaimSubsystem* UInteractionClaimSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+	return World ? UWorld::GetSubsystem<UInteractionClaimSubsystem>(World) : nullptr;
+}
+
+void UInteractionClaimSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Twice the number of claims, so probe sequences stay short
+	const int32 MaxClaims = FMath::Max(UInteractionCoreSettings::Get()->MaxInteractionClaims, 1);
+	const uint32 NumSlots = FMath::RoundUpToPowerOfTwo(uint32(MaxClaims) * 2);
+
+	Slots = MakeUnique<FClaimSlot[]>(NumSlots);
+	SlotMask = NumSlots - 1;
+}
+
+void UInteractionClaimSubsystem::Deinitialize()
+{
+	Slots.Reset();
+	SlotMask = 0;
+	NumClaims = 0;
+
+	Super::Deinitialize();
+}
+
+bool UInteractionClaimSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+bool UInteractionClaimSubsystem::TryClaim(const UObject* Target, int32 InstanceIndex, const UObject* Claimant, float Duration)
+{
+	check(IsInGameThread());
+
+	if (Target == nullptr || Claimant == nullptr || !Slots.IsValid())
+	{
+		return false;
+	}
+
+	if (Duration < 0.f)
+	{
+		Duration = UInteractionCoreSettings::Get()->InteractionClaimDuration;
+	}
+
+	const uint64 Key = InteractionClaims::MakeTargetKey(Target, InstanceIndex);
+	const uint32 ClaimantId = Claimant->GetUniqueID();
+	const uint32 Now = GetClaimTime();
+
+	// Find the slot of the key, or the first slot we can put it in
+	FClaimSlot* Slot = nullptr;
+	FClaimSlot* ReusableSlot = nullptr;
+	const uint32 Hash = uint32(MurmurFinalize64(Key));
+	for (uint32 Probe = 0; Probe <= SlotMask; ++Probe)
+	{
+		FClaimSlot& Candidate = Slots[(Hash + Probe) & SlotMask];
+		const uint64 CandidateKey = Candidate.Key.load(std::memory_order_relaxed);
+		if (CandidateKey == Key)
+		{
+			Slot = &Candidate;
+			break;
+		}
+
+		if (CandidateKey == 0)
+		{
+			Slot = ReusableSlot ? ReusableSlot : &Candidate;
+			break;
+		}
+
+		// Slots are never emptied, so probe sequences stay intact. Released or expired ones are taken over instead.
+		if (ReusableSlot == nullptr && !InteractionClaims::IsClaimActive(Candidate.ClaimWord.load(std::memory_order_relaxed), Now))
+		{
+			ReusableSlot = &Candidate;
+		}
+	}
+
+	if (Slot == nullptr)
+	{
+		Slot = ReusableSlot;
+	}
+
+	// Every slot holds an active claim
+	if (Slot == nullptr)
+	{
+		return false;
+	}
+
+	const uint64 ClaimWord = Slot->ClaimWord.load(std::memory_order_relaxed);
+	if (Slot->Key.load(std::memory_order_relaxed) == Key)
+	{
+		if (InteractionClaims::IsClaimActive(ClaimWord, Now) && InteractionClaims::GetClaimantId(ClaimWord) != ClaimantId)
+		{
+			return false;
+		}
+	}
+	else
+	{
+		// Readers re-check the key after reading the claim word, so they never attribute the new claim to the previous key
+		Slot->Key.store(Key, std::memory_order_release);
+	}
+
+	if (ClaimWord == 0)
+	{
+		NumClaims.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	const uint32 ExpireTime = InteractionClaims::ToClaimTime(GetWorld()->GetTimeSeconds() + Duration);
+	Slot->ClaimWord.store(InteractionClaims::MakeClaimWord(ClaimantId, FMath::Max(ExpireTime, Now + 1)), std::memory_order_release);
+	return true;
+}
+
+void UInteractionClaimSubsystem::Release(const UObject* Target, int32 InstanceIndex, const UObject* Claimant)
+{
+	check(IsInGameThread());
+
+	if (Target == nullptr || Claimant == nullptr)
+	{
+		return;
+	}
+
+	FClaimSlot* Slot = const_cast<FClaimSlot*>(FindSlot(InteractionClaims::MakeTargetKey(Target, InstanceIndex)));
+	if (Slot == nullptr)
+	{
+		return;
+	}
+
+	const uint64 ClaimWord = Slot->ClaimWord.load(std::memory_order_relaxed);
+	if (ClaimWord != 0 && InteractionClaims::GetClaimantId(ClaimWord) == Claimant->GetUniqueID())
+	{
+		Slot->ClaimWord.store(0, std::memory_order_release);
+		NumClaims.fetch_sub(1, std::memory_order_relaxed);
+	}
+}
+
+bool UInteractionClaimSubsystem::IsClaimedByOther(const UObject* Target, int32 InstanceIndex, const UObject* Claimant) const
+{
+	if (Target == nullptr || NumClaims.load(std::memory_order_relaxed) == 0)
+	{
+		return false;
+	}
+
+	const uint64 Key = InteractionClaims::MakeTargetKey(Target, InstanceIndex);
+	const FClaimSlot* Slot = FindSlot(Key);
+	if (Slot == nullptr)
+	{
+		return false;
+	}
+
+	const uint64 ClaimWord = Slot->ClaimWord.load(std::memory_order_acquire);
+
+	// The slot was taken over by another interactable while we were looking at it, so ours isn't claimed anymore
+	if (Slot->Key.load(std::memory_order_acquire) != Key)
+	{
+		return false;
+	}
+
+	return InteractionClaims::IsClaimActive(ClaimWord, GetClaimTime())
+		&& (Claimant == nullptr || InteractionClaims::GetClaimantId(ClaimWord) != Claimant->GetUniqueID());
+}
+
+const UInteractionClaimSubsystem::FClaimSlot* UInteractionClaimSubsystem::FindSlot(uint64 Key) const
+{
+	if (!Slots.IsValid())
+	{
+		return nullptr;
+	}
+
+	const uint32 Hash = uint32(MurmurFinalize64(Key));
+	for (uint32 Probe = 0; Probe <= SlotMask; ++Probe)
+	{
+		const FClaimSlot& Slot = Slots[(Hash + Probe) & SlotMask];
+		const uint64 SlotKey = Slot.Key.load(std::memory_order_acquire);
+		if (SlotKey == Key)
+		{
+			return &Slot;
+		}
+
+		if (SlotKey == 0)
+		{
+			return nullptr;
+		}
+	}
+
+	return nullptr;
+}
+
+uint32 UInteractionClaimSubsystem::GetClaimTime() const
+{
+	const UWorld* World = GetWorld();
+	return World ? InteractionClaims::ToClaimTime(World->GetTimeSeconds()) : 0;
+}
@@ -1,3 +1,24 @@
-﻿#include "Modules/ModuleManager.h"
+﻿#include "InteractionCoreLog.h"
+#include "InteractionCoreStats.h"
+#include "Modules/ModuleManager.h"
+
+DEFINE_LOG_CATEGORY(LogInteractionCore);
+
+DEFINE_STAT(STAT_InteractionScans);
+DEFINE_STAT(STAT_InteractionTraces);
+DEFINE_STAT(STAT_InteractionTraceCacheHits);
+DEFINE_STAT(STAT_InteractableActorsGathered);
+DEFINE_STAT(STAT_InteractionOptionBroadcastsSuppressed);
+DEFINE_STAT(STAT_InteractionIndexRaycasts);
+DEFINE_STAT(STAT_InteractionValidationsRejected);
+DEFINE_STAT(STAT_InteractionProgressUpdates);
+DEFINE_STAT(STAT_InteractionBudgetOverruns);
+DEFINE_STAT(STAT_InteractionBudgetWorkDeferred);
+DEFINE_STAT(STAT_InteractionBudgetScansDeferred);
+DEFINE_STAT(STAT_InteractionBudgetGrantsDeferred);
+DEFINE_STAT(STAT_InteractionBudgetIndicatorProjectionDeferred);
+DEFINE_STAT(STAT_InteractionBudgetIndicatorWidgetsDeferred);
+DEFINE_STAT(STAT_InteractionAbilitiesStreamed);
+DEFINE_STAT(STAT_InteractionHighlightChanges);
     
-IMPLEMENT_MODULE(FDefaultModuleImpl, InteractionCore)
\ No newline at end of file
+IMPLEMENT_MODULE(FDefaultModuleImpl, InteractionCore)
@@ -0,0 +1,131 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+
+#include "InteractionCoreSettings.h"
+
+#include "InteractableIndexTypes.h"
+#include "InteractionCoreLog.h"
+#include "Misc/ScopeLock.h"
+
+#if WITH_EDITOR
+#include "Misc/DataValidation.h"
+#endif
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(InteractionCoreSettings)
+
+#define LOCTEXT_NAMESPACE "InteractionCoreSettings"
+
+namespace InteractionCoreSettings
+{
+	/** Tags that were already warned about, cleared whenever the configured categories change */
+	static TSet<FGameplayTag> WarnedCategoryTags;
+	static uint32 WarnedCategoriesHash = 0;
+	static FCriticalSection WarnedCategoryTagsLock;
+
+	/** Warns about a filter tag that doesn't stand for any configured category, once per tag and category configuration */
+	static void WarnUnconfiguredCategoryTag(const TArray<FGameplayTag>& Categories, const FGameplayTag& Tag)
+	{
+		uint32 CategoriesHash = 0;
+		for (const FGameplayTag& Category : Categories)
+		{
+			CategoriesHash = HashCombine(CategoriesHash, GetTypeHash(Category));
+		}
+
+		FScopeLock ScopeLock(&WarnedCategoryTagsLock);
+
+		if (CategoriesHash != WarnedCategoriesHash)
+		{
+			WarnedCategoriesHash = CategoriesHash;
+			WarnedCategoryTags.Reset();
+		}
+
+		bool bAlreadyWarned;
+		WarnedCategoryTags.Add(Tag, &bAlreadyWarned);
+		if (!bAlreadyWarned)
+		{
+			UE_LOG(LogInteractionCore, Warning, TEXT("%s is not a configured interactable category and doesn't contain any, it is ignored by category filters. See InteractableCategories in the Interaction Core settings."), *Tag.ToString());
+		}
+	}
+}
+
+UInteractionCoreSettings::UInteractionCoreSettings()
+{
+}
+
+#if WITH_EDITOR
+EDataValidationResult UInteractionCoreSettings::IsDataValid(FDataValidationContext& Context) const
+{
+	EDataValidationResult Result = CombineDataValidationResults(Super::IsDataValid(Context), EDataValidationResult::Valid);
+
+	if (InteractableCategories.Num() > 64)
+	{
+		Context.AddError(FText::Format(LOCTEXT("TooManyCategories", "There are {0} interactable categories, only the first 64 can be used."), FText::AsNumber(InteractableCategories.Num())));
+		Result = EDataValidationResult::Invalid;
+	}
+
+	return Result;
+}
+#endif
+
+uint64 UInteractionCoreSettings::MakeCategoryMask(const FGameplayTagContainer& Tags) const
+{
+	if (Tags.IsEmpty())
+	{
+		return 0;
+	}
+
+	uint64 CategoryMask = 0;
+
+	const int32 NumCategories = FMath::Min(InteractableCategories.Num(), 64);
+	for (int32 CategoryIdx = 0; CategoryIdx < NumCategories; ++CategoryIdx)
+	{
+		if (Tags.HasTag(InteractableCategories[CategoryIdx]))
+		{
+			CategoryMask |= uint64(1) << CategoryIdx;
+		}
+	}
+
+	return CategoryMask;
+}
+
+FInteractableCategoryFilter UInteractionCoreSettings::MakeCategoryFilter(
+	const FGameplayTagContainer& IncludeTags, const FGameplayTagContainer& ExcludeTags) const
+{
+	// Unlike the tags of an interactable, a filter tag stands for the categories below it and not for the one it belongs to,
+	// otherwise asking for a child tag would accept its whole parent category
+	const int32 NumCategories = FMath::Min(InteractableCategories.Num(), 64);
+	const auto MakeFilterMask = [this, NumCategories](const FGameplayTagContainer& Tags)
+	{
+		uint64 FilterMask = 0;
+		for (const FGameplayTag& Tag : Tags)
+		{
+			uint64 TagMask = 0;
+			for (int32 CategoryIdx = 0; CategoryIdx < NumCategories; ++CategoryIdx)
+			{
+				if (InteractableCategories[CategoryIdx].MatchesTag(Tag))
+				{
+					TagMask |= uint64(1) << CategoryIdx;
+				}
+			}
+
+			if (TagMask == 0)
+			{
+				InteractionCoreSettings::WarnUnconfiguredCategoryTag(InteractableCategories, Tag);
+			}
+
+			FilterMask |= TagMask;
+		}
+
+		return FilterMask;
+	};
+
+	FInteractableCategoryFilter CategoryFilter;
+	CategoryFilter.IncludeMask = MakeFilterMask(IncludeTags);
+	CategoryFilter.ExcludeMask = MakeFilterMask(ExcludeTags);
+
+	// An include mask of 0 accepts everything, which is the opposite of asking for categories that don't exist
+	CategoryFilter.bRejectAll = !IncludeTags.IsEmpty() && CategoryFilter.IncludeMask == 0;
+	return CategoryFilter;
+}
+
+#undef LOCTEXT_NAMESPACE
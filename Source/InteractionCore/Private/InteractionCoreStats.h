@@ -0,0 +1,49 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("InteractionCore"), STATGROUP_InteractionCore, STATCAT_Advanced);
+
+/** Number of scans performed by all interaction scanners */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Interaction Scans"), STAT_InteractionScans, STATGROUP_InteractionCore, );
+
+/** Number of physics traces issued by interaction scans and targeting */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Interaction Traces"), STAT_InteractionTraces, STATGROUP_InteractionCore, );
+
+/** Number of interaction traces that were served by the per-avatar trace cache */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Interaction Trace Cache Hits"), STAT_InteractionTraceCacheHits, STATGROUP_InteractionCore, );
+
+/** Number of actors of streamed in levels that were checked for interactables */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Interactable Actors Gathered"), STAT_InteractableActorsGathered, STATGROUP_InteractionCore, );
+
+/** Number of interaction option changes that were coalesced into a later broadcast */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Interaction Option Broadcasts Suppressed"), STAT_InteractionOptionBroadcastsSuppressed, STATGROUP_InteractionCore, );
+
+/** Number of interaction rays tested against the interactable index instead of the physics scene */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Interaction Index Raycasts"), STAT_InteractionIndexRaycasts, STATGROUP_InteractionCore, );
+
+/** Number of interactions rejected by validating them against the interactable index */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Interaction Validations Rejected"), STAT_InteractionValidationsRejected, STATGROUP_InteractionCore, );
+
+/** Number of progress interactions advanced by the batched progress update */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Interaction Progress Updates"), STAT_InteractionProgressUpdates, STATGROUP_InteractionCore, );
+
+/** Number of times a category of the interaction frame budget ran over its budget, at most once per category and frame */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Interaction Budget Overruns"), STAT_InteractionBudgetOverruns, STATGROUP_InteractionCore, );
+
+/** Number of pieces of work deferred to a later frame because their frame budget was spent */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Interaction Budget Work Deferred"), STAT_InteractionBudgetWorkDeferred, STATGROUP_InteractionCore, );
+
+/** Number of pieces of work of each budget category deferred to a later frame */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Interaction Budget Scans Deferred"), STAT_InteractionBudgetScansDeferred, STATGROUP_InteractionCore, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Interaction Budget Grants Deferred"), STAT_InteractionBudgetGrantsDeferred, STATGROUP_InteractionCore, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Interaction Budget Indicator Projections Deferred"), STAT_InteractionBudgetIndicatorProjectionDeferred, STATGROUP_InteractionCore, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Interaction Budget Indicator Widgets Deferred"), STAT_InteractionBudgetIndicatorWidgetsDeferred, STATGROUP_InteractionCore, );
+
+/** Number of soft-referenced interaction abilities that were requested to stream in */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Interaction Abilities Streamed"), STAT_InteractionAbilitiesStreamed, STATGROUP_InteractionCore, );
+
+/** Number of primitives whose custom depth render state was changed by the interaction highlights */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Interaction Highlight Changes"), STAT_InteractionHighlightChanges, STATGROUP_InteractionCore, );
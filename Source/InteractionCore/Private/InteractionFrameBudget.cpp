@@ -0,0 +1,170 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+
+#include "InteractionFrameBudget.h"
+
+#include "InteractionCoreSettings.h"
+#include "InteractionCoreStats.h"
+#include "Scalability.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(InteractionFrameBudget)
+
+//////////////////////////////////////////////////////////////////////////
+/// FInteractionFrameBudgets
+
+int32 FInteractionFrameBudgets::GetBudget(EInteractionBudgetCategory Category) const
+{
+	switch (Category)
+	{
+	case EInteractionBudgetCategory::Scans:
+		return Scans;
+	case EInteractionBudgetCategory::Grants:
+		return Grants;
+	case EInteractionBudgetCategory::IndicatorProjection:
+		return IndicatorProjection;
+	case EInteractionBudgetCategory::IndicatorWidgets:
+		return IndicatorWidgets;
+	default:
+		return 0;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// FInteractionFrameBudget
+
+FInteractionFrameBudget& FInteractionFrameBudget::Get()
+{
+	static FInteractionFrameBudget Budget;
+	return Budget;
+}
+
+bool FInteractionFrameBudget::HasBudget(EInteractionBudgetCategory Category)
+{
+	FCategoryState& State = GetState(Category);
+	if (State.Budget <= 0.0 || State.NumStarted == 0 || State.Used < State.Budget)
+	{
+		++State.NumStarted;
+		return true;
+	}
+
+	return false;
+}
+
+void FInteractionFrameBudget::ConsumeBudget(EInteractionBudgetCategory Category, double Microseconds)
+{
+	FCategoryState& State = GetState(Category);
+	State.Used += Microseconds;
+
+	// Only the first overrun of each category and frame is counted
+	if (State.Budget > 0.0 && State.Used > State.Budget && !State.bOverrun)
+	{
+		State.bOverrun = true;
+		INC_DWORD_STAT(STAT_InteractionBudgetOverruns);
+	}
+}
+
+void FInteractionFrameBudget::ReportDeferred(EInteractionBudgetCategory Category, int32 NumDeferred)
+{
+	GetState(Category).NumDeferred += NumDeferred;
+	INC_DWORD_STAT_BY(STAT_InteractionBudgetWorkDeferred, NumDeferred);
+
+	switch (Category)
+	{
+	case EInteractionBudgetCategory::Scans:
+		INC_DWORD_STAT_BY(STAT_InteractionBudgetScansDeferred, NumDeferred);
+		break;
+	case EInteractionBudgetCategory::Grants:
+		INC_DWORD_STAT_BY(STAT_InteractionBudgetGrantsDeferred, NumDeferred);
+		break;
+	case EInteractionBudgetCategory::IndicatorProjection:
+		INC_DWORD_STAT_BY(STAT_InteractionBudgetIndicatorProjectionDeferred, NumDeferred);
+		break;
+	case EInteractionBudgetCategory::IndicatorWidgets:
+		INC_DWORD_STAT_BY(STAT_InteractionBudgetIndicatorWidgetsDeferred, NumDeferred);
+		break;
+	default:
+		break;
+	}
+}
+
+int32 FInteractionFrameBudget::GetNumDeferred(EInteractionBudgetCategory Category)
+{
+	return GetState(Category).NumDeferred;
+}
+
+double FInteractionFrameBudget::GetBudget(EInteractionBudgetCategory Category)
+{
+	return GetState(Category).Budget;
+}
+
+double FInteractionFrameBudget::GetUsedBudget(EInteractionBudgetCategory Category)
+{
+	return GetState(Category).Used;
+}
+
+float FInteractionFrameBudget::GetAgedPriority(float Priority, int32 FramesDeferred)
+{
+	return Priority + FramesDeferred * UInteractionCoreSettings::Get()->DeferredWorkPriorityPerFrame;
+}
+
+void FInteractionFrameBudget::BeginFrameIfNeeded()
+{
+	check(IsInGameThread());
+
+	if (FrameNumber == GFrameCounter)
+	{
+		return;
+	}
+
+	FrameNumber = GFrameCounter;
+
+	// The lowest level of any scalability group, so a single lowered group is enough to lower the budgets
+	const TArray<FInteractionFrameBudgets>& BudgetsByScalability = UInteractionCoreSettings::Get()->FrameBudgetsByScalability;
+	const FInteractionFrameBudgets* Budgets = nullptr;
+	if (BudgetsByScalability.Num() > 0)
+	{
+		const int32 QualityLevel = Scalability::GetQualityLevels().GetMinQualityLevel();
+		Budgets = &BudgetsByScalability[FMath::Clamp(QualityLevel, 0, BudgetsByScalability.Num() - 1)];
+	}
+
+	for (int32 CategoryIdx = 0; CategoryIdx < UE_ARRAY_COUNT(States); ++CategoryIdx)
+	{
+		FCategoryState& State = States[CategoryIdx];
+		State = FCategoryState();
+		State.Budget = Budgets ? Budgets->GetBudget(static_cast<EInteractionBudgetCategory>(CategoryIdx)) : 0.0;
+	}
+}
+
+FInteractionFrameBudget::FCategoryState& FInteractionFrameBudget::GetState(EInteractionBudgetCategory Category)
+{
+	BeginFrameIfNeeded();
+
+	check(Category < EInteractionBudgetCategory::MAX);
+	return States[static_cast<int32>(Category)];
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// FInteractionBudgetScope
+
+FInteractionBudgetScope::FInteractionBudgetScope(EInteractionBudgetCategory InCategory)
+	: Category(InCategory)
+	, StartCycles(FPlatformTime::Cycles64())
+{
+	FInteractionFrameBudget& Budget = FInteractionFrameBudget::Get();
+	OuterScope = Budget.ActiveScope;
+	Budget.ActiveScope = this;
+}
+
+FInteractionBudgetScope::~FInteractionBudgetScope()
+{
+	const uint64 Cycles = FPlatformTime::Cycles64() - StartCycles;
+
+	FInteractionFrameBudget& Budget = FInteractionFrameBudget::Get();
+	Budget.ActiveScope = OuterScope;
+	if (OuterScope)
+	{
+		OuterScope->InnerCycles += Cycles;
+	}
+
+	Budget.ConsumeBudget(Category, FPlatformTime::ToMilliseconds64(Cycles - FMath::Min(InnerCycles, Cycles)) * 1000.0);
+}
@@ -0,0 +1,261 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+
+#include "InteractionHighlightSubsystem.h"
+
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "InteractionCoreSettings.h"
+#include "InteractionCoreStats.h"
+#include "InteractionOption.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(InteractionHighlightSubsystem)
+
+UInteractionHighlightSubsystem::UInteractionHighlightSubsystem()
+{
+}
+
+UInteractionHighlightSubsystem* UInteractionHighlightSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+	return World ? UWorld::GetSubsystem<UInteractionHighlightSubsystem>(World) : nullptr;
+}
+
+bool UInteractionHighlightSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// Nothing is rendered on dedicated servers
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UInteractionHighlightSubsystem::Deinitialize()
+{
+	for (const TPair<TWeakObjectPtr<UPrimitiveComponent>, FSavedRenderState>& Highlighted : HighlightedPrimitives)
+	{
+		if (UPrimitiveComponent* Primitive = Highlighted.Key.Get())
+		{
+			RestorePrimitive(Primitive, Highlighted.Value);
+		}
+	}
+	HighlightedPrimitives.Reset();
+	FocusedInteractables.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UInteractionHighlightSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UInteractionHighlightSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	PurgeStaleFocus();
+	FlushHighlights();
+}
+
+TStatId UInteractionHighlightSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UInteractionHighlightSubsystem, STATGROUP_Tickables);
+}
+
+void UInteractionHighlightSubsystem::SetFocusedInteractables(const UObject* FocusOwner, const TArray<UObject*>& Interactables)
+{
+	if (FocusOwner == nullptr)
+	{
+		return;
+	}
+
+	if (Interactables.Num() == 0)
+	{
+		ClearFocusedInteractables(FocusOwner);
+		return;
+	}
+
+	TArray<TWeakObjectPtr<UObject>>& Focused = FocusedInteractables.FindOrAdd(FocusOwner);
+
+	// Nothing to do if the owner keeps focusing the same interactables
+	bool bFocusChanged = Focused.Num() != Interactables.Num();
+	for (int32 InteractableIdx = 0; !bFocusChanged && InteractableIdx < Interactables.Num(); ++InteractableIdx)
+	{
+		bFocusChanged = Focused[InteractableIdx] != Interactables[InteractableIdx];
+	}
+
+	if (bFocusChanged)
+	{
+		Focused.Reset(Interactables.Num());
+		Focused.Append(Interactables);
+		bHighlightsDirty = true;
+	}
+}
+
+void UInteractionHighlightSubsystem::SetFocusedInteractionOptions(const UObject* FocusOwner, const TArray<FInteractionOption>& Options)
+{
+	TArray<UObject*> Interactables;
+	for (const FInteractionOption& Option : Options)
+	{
+		if (Option.InteractableInstanceIndex == INDEX_NONE)
+		{
+			Interactables.AddUnique(Option.InteractableTarget.GetObject());
+		}
+	}
+
+	SetFocusedInteractables(FocusOwner, Interactables);
+}
+
+void UInteractionHighlightSubsystem::ClearFocusedInteractables(const UObject* FocusOwner)
+{
+	if (FocusedInteractables.Remove(FocusOwner) > 0)
+	{
+		bHighlightsDirty = true;
+	}
+}
+
+void UInteractionHighlightSubsystem::PurgeStaleFocus()
+{
+	for (auto It = FocusedInteractables.CreateIterator(); It; ++It)
+	{
+		// Owners are expected to clear their focus, but don't keep highlighting for owners that went away without doing so
+		if (It.Key().ResolveObjectPtr() == nullptr)
+		{
+			It.RemoveCurrent();
+			bHighlightsDirty = true;
+			continue;
+		}
+
+		if (It.Value().RemoveAll([](const TWeakObjectPtr<UObject>& Interactable) { return !Interactable.IsValid(); }) > 0)
+		{
+			bHighlightsDirty = true;
+			if (It.Value().Num() == 0)
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	// Destroyed primitives don't need restoring, just forget about them
+	for (auto It = HighlightedPrimitives.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void UInteractionHighlightSubsystem::FlushHighlights()
+{
+	if (!bHighlightsDirty)
+	{
+		return;
+	}
+
+	bHighlightsDirty = false;
+
+	TSet<UPrimitiveComponent*> NewPrimitives;
+	for (auto It = FocusedInteractables.CreateIterator(); It; ++It)
+	{
+		if (It.Key().ResolveObjectPtr() == nullptr)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		for (const TWeakObjectPtr<UObject>& Interactable : It.Value())
+		{
+			if (UObject* InteractableObject = Interactable.Get())
+			{
+				GatherPrimitives(InteractableObject, NewPrimitives);
+			}
+		}
+	}
+
+	// Primitives that stay highlighted are left alone, only those that lost focus are restored
+	for (auto It = HighlightedPrimitives.CreateIterator(); It; ++It)
+	{
+		UPrimitiveComponent* Primitive = It.Key().Get();
+		if (Primitive == nullptr)
+		{
+			It.RemoveCurrent();
+		}
+		else if (NewPrimitives.Remove(Primitive) == 0)
+		{
+			RestorePrimitive(Primitive, It.Value());
+			It.RemoveCurrent();
+		}
+	}
+
+	// Whatever is left just gained focus
+	const int32 StencilValue = UInteractionCoreSettings::Get()->HighlightStencilValue;
+	for (UPrimitiveComponent* Primitive : NewPrimitives)
+	{
+		HighlightPrimitive(Primitive, StencilValue);
+	}
+}
+
+bool UInteractionHighlightSubsystem::IsHighlighted(const UPrimitiveComponent* Primitive) const
+{
+	return Primitive && HighlightedPrimitives.Contains(const_cast<UPrimitiveComponent*>(Primitive));
+}
+
+void UInteractionHighlightSubsystem::GatherPrimitives(UObject* Interactable, TSet<UPrimitiveComponent*>& OutPrimitives)
+{
+	if (UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(Interactable))
+	{
+		OutPrimitives.Add(Primitive);
+		return;
+	}
+
+	AActor* Actor = Cast<AActor>(Interactable);
+	if (Actor == nullptr)
+	{
+		if (const UActorComponent* Component = Cast<UActorComponent>(Interactable))
+		{
+			Actor = Component->GetOwner();
+		}
+	}
+
+	if (Actor == nullptr)
+	{
+		return;
+	}
+
+	// Collision only primitives like interaction volumes aren't rendered, so there is no point in touching their render state
+	Actor->ForEachComponent<UPrimitiveComponent>(false, [&OutPrimitives](UPrimitiveComponent* Primitive)
+	{
+		if (Primitive->IsVisible() && !Primitive->bHiddenInGame)
+		{
+			OutPrimitives.Add(Primitive);
+		}
+	});
+}
+
+void UInteractionHighlightSubsystem::HighlightPrimitive(UPrimitiveComponent* Primitive, int32 StencilValue)
+{
+	FSavedRenderState& SavedState = HighlightedPrimitives.Add(Primitive);
+	SavedState.bRenderCustomDepth = Primitive->bRenderCustomDepth;
+	SavedState.CustomDepthStencilValue = Primitive->CustomDepthStencilValue;
+
+	if (!Primitive->bRenderCustomDepth || Primitive->CustomDepthStencilValue != StencilValue)
+	{
+		INC_DWORD_STAT(STAT_InteractionHighlightChanges);
+		++NumRenderStateChanges;
+
+		Primitive->SetRenderCustomDepth(true);
+		Primitive->SetCustomDepthStencilValue(StencilValue);
+	}
+}
+
+void UInteractionHighlightSubsystem::RestorePrimitive(UPrimitiveComponent* Primitive, const FSavedRenderState& SavedState)
+{
+	if (Primitive->bRenderCustomDepth != SavedState.bRenderCustomDepth || Primitive->CustomDepthStencilValue != SavedState.CustomDepthStencilValue)
+	{
+		INC_DWORD_STAT(STAT_InteractionHighlightChanges);
+		++NumRenderStateChanges;
+
+		Primitive->SetRenderCustomDepth(SavedState.bRenderCustomDepth);
+		Primitive->SetCustomDepthStencilValue(SavedState.CustomDepthStencilValue);
+	}
+}
@@ -0,0 +1,148 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+
+#include "InteractionOptionTemplateSubsystem.h"
+
+#include "Data/InteractionOptionTemplates.h"
+#include "Engine/AssetManager.h"
+#include "Engine/GameInstance.h"
+#include "Engine/StreamableManager.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(InteractionOptionTemplateSubsystem)
+
+UInteractionOptionTemplateSubsystem::UInteractionOptionTemplateSubsystem()
+{
+}
+
+UInteractionOptionTemplateSubsystem* UInteractionOptionTemplateSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+	const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	return GameInstance ? GameInstance->GetSubsystem<UInteractionOptionTemplateSubsystem>() : nullptr;
+}
+
+void UInteractionOptionTemplateSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	ReloadTemplates();
+
+#if WITH_EDITOR
+	ObjectPropertyChangedHandle = FCoreUObjectDelegates::OnObjectPropertyChanged.AddUObject(this, &ThisClass::OnObjectPropertyChanged);
+#endif
+}
+
+void UInteractionOptionTemplateSubsystem::Deinitialize()
+{
+#if WITH_EDITOR
+	FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(ObjectPropertyChangedHandle);
+#endif
+
+	if (TemplatesHandle.IsValid())
+	{
+		TemplatesHandle->ReleaseHandle();
+		TemplatesHandle.Reset();
+	}
+
+	if (WidgetClassesHandle.IsValid())
+	{
+		WidgetClassesHandle->ReleaseHandle();
+		WidgetClassesHandle.Reset();
+	}
+
+	TemplateAssets.Reset();
+	ResolvedOptions.Reset();
+
+	Super::Deinitialize();
+}
+
+const FInteractionOption* UInteractionOptionTemplateSubsystem::FindOptionTemplate(const FGameplayTag& TemplateId) const
+{
+	return ResolvedOptions.Find(TemplateId);
+}
+
+void UInteractionOptionTemplateSubsystem::ReloadTemplates()
+{
+	UAssetManager* AssetManager = UAssetManager::GetIfInitialized();
+	if (AssetManager == nullptr)
+	{
+		return;
+	}
+
+	TArray<FPrimaryAssetId> TemplateAssetIds;
+	AssetManager->GetPrimaryAssetIdList(UInteractionOptionTemplates::PrimaryAssetType, TemplateAssetIds);
+
+	// Templates are loaded once up front, so that resolving them never hits the disk later on
+	TemplatesHandle = AssetManager->LoadPrimaryAssets(TemplateAssetIds);
+	if (TemplatesHandle.IsValid())
+	{
+		TemplatesHandle->WaitUntilComplete();
+	}
+
+	TemplateAssets.Reset();
+	for (const FPrimaryAssetId& TemplateAssetId : TemplateAssetIds)
+	{
+		if (UInteractionOptionTemplates* TemplateAsset = AssetManager->GetPrimaryAssetObject<UInteractionOptionTemplates>(TemplateAssetId))
+		{
+			TemplateAssets.Add(TemplateAsset);
+		}
+	}
+
+	RebuildResolvedOptions();
+}
+
+void UInteractionOptionTemplateSubsystem::RebuildResolvedOptions()
+{
+	ResolvedOptions.Reset();
+
+	TArray<FSoftObjectPath> WidgetClassPaths;
+	for (const UInteractionOptionTemplates* TemplateAsset : TemplateAssets)
+	{
+		for (const FInteractionOptionTemplate& Template : TemplateAsset->Templates)
+		{
+			if (!Template.TemplateId.IsValid())
+			{
+				continue;
+			}
+
+			FInteractionOption& Option = ResolvedOptions.FindOrAdd(Template.TemplateId);
+			Template.BuildOption(Option);
+
+			if (!Template.InteractionWidgetClass.IsNull())
+			{
+				WidgetClassPaths.AddUnique(Template.InteractionWidgetClass.ToSoftObjectPath());
+			}
+		}
+	}
+
+	// Keep the widget classes resident, so resolving them for a prompt never causes a synchronous load
+	TSharedPtr<FStreamableHandle> PreviousWidgetClassesHandle = WidgetClassesHandle;
+	WidgetClassesHandle = WidgetClassPaths.Num() > 0
+		? UAssetManager::GetStreamableManager().RequestSyncLoad(WidgetClassPaths)
+		: nullptr;
+
+	if (PreviousWidgetClassesHandle.IsValid())
+	{
+		PreviousWidgetClassesHandle->ReleaseHandle();
+	}
+}
+
+#if WITH_EDITOR
+void UInteractionOptionTemplateSubsystem::OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent)
+{
+	if (!Object || !Object->IsA<UInteractionOptionTemplates>())
+	{
+		return;
+	}
+
+	// Newly created template assets aren't known yet, so do a full reload in that case
+	if (TemplateAssets.Contains(Object))
+	{
+		RebuildResolvedOptions();
+	}
+	else
+	{
+		ReloadTemplates();
+	}
+}
+#endif
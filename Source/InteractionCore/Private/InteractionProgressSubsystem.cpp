@@ -0,0 +1,266 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+
+#include "InteractionProgressSubsystem.h"
+
+#include "AbilitySystemComponent.h"
+#include "AbilitySystemGlobals.h"
+#include "Components/SceneComponent.h"
+#include "GameFramework/Actor.h"
+#include "InteractableIndexSubsystem.h"
+#include "InteractionCoreStats.h"
+#include "InteractionStatics.h"
+#include "Interfaces/IInteractableTarget.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(InteractionProgressSubsystem)
+
+namespace InteractionProgress
+{
+	/** Returns where the target is right now, the bounds of the hit instance for instanced targets */
+	static FBox GetCurrentTargetBounds(const TScriptInterface<IInteractableTarget>& Interactable, int32 InstanceIndex)
+	{
+		if (InstanceIndex != INDEX_NONE)
+		{
+			TArray<FInteractableIndexEntry> Entries;
+			Interactable->GatherInteractableInstanceIndexEntries(InstanceIndex, Entries);
+			if (Entries.Num() > 0)
+			{
+				return Entries[0].Bounds.IsValid ? Entries[0].Bounds : FBox(Entries[0].Location, Entries[0].Location);
+			}
+		}
+
+		if (const USceneComponent* SceneComponent = Cast<USceneComponent>(Interactable.GetObject()))
+		{
+			return SceneComponent->Bounds.GetBox();
+		}
+
+		const AActor* TargetActor = UInteractionStatics::GetActorFromInteractableTarget(Interactable);
+		if (TargetActor == nullptr)
+		{
+			return FBox(ForceInit);
+		}
+
+		// Same colliding components the index derives the bounds of actors from
+		const FBox ActorBounds = TargetActor->GetComponentsBoundingBox();
+		return ActorBounds.IsValid ? ActorBounds : FBox(TargetActor->GetActorLocation(), TargetActor->GetActorLocation());
+	}
+}
+
+UInteractionProgressSubsystem::UInteractionProgressSubsystem()
+{
+}
+
+UInteractionProgressSubsystem* UInteractionProgressSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+	return World ? UWorld::GetSubsystem<UInteractionProgressSubsystem>(World) : nullptr;
+}
+
+void UInteractionProgressSubsystem::Deinitialize()
+{
+	InProgress.Reset();
+	EndedProgress.Reset();
+	OnProgressEnded.Clear();
+
+	Super::Deinitialize();
+}
+
+bool UInteractionProgressSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UInteractionProgressSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (InProgress.Num() == 0)
+	{
+		DispatchEndedProgress();
+		return;
+	}
+
+	INC_DWORD_STAT_BY(STAT_InteractionProgressUpdates, InProgress.Num());
+
+	// Targets only have to be looked up again if anything was added to or removed from the index
+	const UInteractableIndexSubsystem* IndexSubsystem = UInteractableIndexSubsystem::Get(this);
+	const bool bResolveTargets = IndexSubsystem && IndexSubsystem->GetIndexRevision() != ResolvedIndexRevision;
+	if (IndexSubsystem)
+	{
+		ResolvedIndexRevision = IndexSubsystem->GetIndexRevision();
+	}
+
+	for (int32 ProgressIdx = InProgress.Num() - 1; ProgressIdx >= 0; --ProgressIdx)
+	{
+		FInteractionProgress& Progress = InProgress[ProgressIdx];
+
+		const AActor* Instigator = Progress.Instigator.Get();
+		bool bInRange = Instigator && Progress.Target.IsValid();
+		if (bInRange)
+		{
+			const FVector InstigatorLocation = Instigator->GetActorLocation();
+			if (bResolveTargets || !Progress.bIndexed)
+			{
+				bInRange = ResolveTarget(Progress, InstigatorLocation, bResolveTargets);
+			}
+			else
+			{
+				bInRange = Progress.TargetBounds.ComputeSquaredDistanceToPoint(InstigatorLocation) <= FMath::Square(Progress.MaxRange);
+			}
+		}
+
+		Progress.Elapsed += DeltaTime;
+
+		const bool bCompleted = bInRange && Progress.Elapsed >= Progress.Duration;
+		if (bCompleted || !bInRange)
+		{
+			FEndedProgress& Ended = EndedProgress.AddDefaulted_GetRef();
+			Ended.Progress = MoveTemp(Progress);
+			Ended.bCompleted = bCompleted;
+			InProgress.RemoveAtSwap(ProgressIdx, 1, EAllowShrinking::No);
+		}
+	}
+
+	DispatchEndedProgress();
+}
+
+TStatId UInteractionProgressSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UInteractionProgressSubsystem, STATGROUP_Tickables);
+}
+
+int32 UInteractionProgressSubsystem::StartProgress(
+	AActor* Instigator, UObject* Target, int32 InstanceIndex, float Duration, float MaxRange,
+	FGameplayTag CompletedEventTag, FGameplayTag CancelledEventTag)
+{
+	if (Instigator == nullptr || Target == nullptr)
+	{
+		return INDEX_NONE;
+	}
+
+	FInteractionProgress Progress;
+	Progress.Handle = NextHandle++;
+	Progress.Duration = FMath::Max(Duration, 0.f);
+	Progress.MaxRange = FMath::Max(MaxRange, 0.f);
+	Progress.Instigator = Instigator;
+	Progress.Target = Target;
+	Progress.InstanceIndex = InstanceIndex;
+	Progress.CompletedEventTag = CompletedEventTag;
+	Progress.CancelledEventTag = CancelledEventTag;
+
+	const TScriptInterface<IInteractableTarget> Interactable(Target);
+	Progress.bMoving = Interactable && Interactable->IsMovingInteractable();
+
+	if (!ResolveTarget(Progress, Instigator->GetActorLocation(), true))
+	{
+		return INDEX_NONE;
+	}
+
+	// Completes with the next update if there's nothing to hold
+	InProgress.Add(MoveTemp(Progress));
+	return InProgress.Last().Handle;
+}
+
+void UInteractionProgressSubsystem::CancelProgress(int32 ProgressHandle)
+{
+	const int32 ProgressIdx = InProgress.IndexOfByPredicate([ProgressHandle](const FInteractionProgress& Progress)
+	{
+		return Progress.Handle == ProgressHandle;
+	});
+
+	if (ProgressIdx != INDEX_NONE)
+	{
+		FEndedProgress& Ended = EndedProgress.AddDefaulted_GetRef();
+		Ended.Progress = MoveTemp(InProgress[ProgressIdx]);
+		Ended.bCompleted = false;
+		InProgress.RemoveAtSwap(ProgressIdx, 1, EAllowShrinking::No);
+	}
+}
+
+float UInteractionProgressSubsystem::GetProgress(int32 ProgressHandle) const
+{
+	const FInteractionProgress* Progress = InProgress.FindByPredicate([ProgressHandle](const FInteractionProgress& Progress)
+	{
+		return Progress.Handle == ProgressHandle;
+	});
+
+	if (Progress == nullptr)
+	{
+		return -1.f;
+	}
+
+	return Progress->Duration > 0.f ? FMath::Min(Progress->Elapsed / Progress->Duration, 1.f) : 1.f;
+}
+
+bool UInteractionProgressSubsystem::ResolveTarget(FInteractionProgress& Progress, const FVector& InstigatorLocation, bool bLookUpIndex) const
+{
+	const UObject* Target = Progress.Target.Get();
+	if (Target == nullptr)
+	{
+		return false;
+	}
+
+	// Indexed targets are tested against the same bounds the scans found them with. The index only catches up with moving
+	// targets every sample, so those are followed instead, otherwise a hold on a vehicle would go on after it drove away.
+	const UInteractableIndexSubsystem* IndexSubsystem = bLookUpIndex && !Progress.bMoving ? UInteractableIndexSubsystem::Get(this) : nullptr;
+	if (IndexSubsystem)
+	{
+		FInteractableIndexEntry Entry;
+		if (IndexSubsystem->FindInteractable(FInteractableIndexEntryKey(Target, Progress.InstanceIndex), InstigatorLocation, Progress.MaxRange, Entry))
+		{
+			Progress.TargetBounds = Entry.Bounds.IsValid ? Entry.Bounds : FBox(Entry.Location, Entry.Location);
+			Progress.bIndexed = true;
+			return true;
+		}
+
+		// An indexed target that can't be found anymore is either out of range or gone
+		if (Progress.bIndexed)
+		{
+			return false;
+		}
+	}
+
+	const TScriptInterface<IInteractableTarget> Interactable(const_cast<UObject*>(Target));
+	if (!Interactable)
+	{
+		return false;
+	}
+
+	// Measured to the bounds like indexed targets are, large targets would cancel early if measured to their origin
+	Progress.TargetBounds = InteractionProgress::GetCurrentTargetBounds(Interactable, Progress.InstanceIndex);
+	Progress.bIndexed = false;
+	return Progress.TargetBounds.IsValid && Progress.TargetBounds.ComputeSquaredDistanceToPoint(InstigatorLocation) <= FMath::Square(Progress.MaxRange);
+}
+
+void UInteractionProgressSubsystem::DispatchEndedProgress()
+{
+	if (EndedProgress.Num() == 0)
+	{
+		return;
+	}
+
+	// Events can start or cancel other interactions, so they only ever see the next batch
+	TArray<FEndedProgress> Batch = MoveTemp(EndedProgress);
+	EndedProgress.Reset();
+
+	for (const FEndedProgress& Ended : Batch)
+	{
+		const FInteractionProgress& Progress = Ended.Progress;
+		const FGameplayTag& EventTag = Ended.bCompleted ? Progress.CompletedEventTag : Progress.CancelledEventTag;
+
+		AActor* Instigator = Progress.Instigator.Get();
+		UAbilitySystemComponent* AbilitySystem = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Instigator);
+		if (AbilitySystem && EventTag.IsValid())
+		{
+			FGameplayEventData Payload;
+			Payload.EventTag = EventTag;
+			Payload.Instigator = Instigator;
+			Payload.Target = UInteractionStatics::GetActorFromInteractableTarget(TScriptInterface<IInteractableTarget>(Progress.Target.Get()));
+			Payload.OptionalObject = Progress.Target.Get();
+			Payload.EventMagnitude = Progress.Elapsed;
+			AbilitySystem->HandleGameplayEvent(EventTag, &Payload);
+		}
+
+		OnProgressEnded.Broadcast(Progress.Handle, Ended.bCompleted);
+	}
+}
@@ -0,0 +1,174 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+
+#include "InteractionPromptWidgetSubsystem.h"
+
+#include "Blueprint/UserWidget.h"
+#include "Engine/AssetManager.h"
+#include "Engine/LocalPlayer.h"
+#include "Engine/StreamableManager.h"
+#include "GameFramework/PlayerController.h"
+#include "InteractionCoreSettings.h"
+#include "InteractionOption.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(InteractionPromptWidgetSubsystem)
+
+UInteractionPromptWidgetSubsystem::UInteractionPromptWidgetSubsystem()
+{
+}
+
+UInteractionPromptWidgetSubsystem* UInteractionPromptWidgetSubsystem::Get(const APlayerController* PlayerController)
+{
+	const ULocalPlayer* LocalPlayer = PlayerController ? PlayerController->GetLocalPlayer() : nullptr;
+	return LocalPlayer ? LocalPlayer->GetSubsystem<UInteractionPromptWidgetSubsystem>() : nullptr;
+}
+
+void UInteractionPromptWidgetSubsystem::Deinitialize()
+{
+	for (const TPair<FSoftObjectPath, TSharedPtr<FStreamableHandle>>& PendingLoad : PendingLoads)
+	{
+		if (PendingLoad.Value.IsValid())
+		{
+			PendingLoad.Value->CancelHandle();
+		}
+	}
+	PendingLoads.Reset();
+
+	PromptWidgetPool.ResetPool();
+	LoadedWidgetClasses.Reset();
+
+	Super::Deinitialize();
+}
+
+void UInteractionPromptWidgetSubsystem::PreloadWidgetClass(TSoftClassPtr<UUserWidget> WidgetClass)
+{
+	if (WidgetClass.IsNull())
+	{
+		return;
+	}
+
+	const FSoftObjectPath WidgetClassPath = WidgetClass.ToSoftObjectPath();
+	if (PendingLoads.Contains(WidgetClassPath))
+	{
+		return;
+	}
+
+	// Already loaded, possibly by someone else
+	if (UClass* LoadedClass = WidgetClass.Get())
+	{
+		if (!LoadedWidgetClasses.Contains(LoadedClass))
+		{
+			OnWidgetClassLoaded(WidgetClass);
+		}
+		return;
+	}
+
+	TSharedPtr<FStreamableHandle> Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+		WidgetClassPath,
+		FStreamableDelegate::CreateUObject(this, &ThisClass::OnWidgetClassLoaded, WidgetClass),
+		FStreamableManager::AsyncLoadHighPriority);
+
+	if (Handle.IsValid() && !Handle->HasLoadCompleted())
+	{
+		PendingLoads.Add(WidgetClassPath, Handle);
+	}
+}
+
+void UInteractionPromptWidgetSubsystem::PreloadWidgetClasses(const TArray<FInteractionOption>& Options)
+{
+	for (const FInteractionOption& Option : Options)
+	{
+		PreloadWidgetClass(Option.InteractionWidgetClass);
+	}
+}
+
+UUserWidget* UInteractionPromptWidgetSubsystem::AcquirePromptWidget(TSoftClassPtr<UUserWidget> WidgetClass)
+{
+	UClass* LoadedClass = WidgetClass.Get();
+	if (LoadedClass == nullptr)
+	{
+		// Never load synchronously here, the prompt will be available on one of the next scans
+		PreloadWidgetClass(WidgetClass);
+		return nullptr;
+	}
+
+	if (!UpdatePoolOwner())
+	{
+		return nullptr;
+	}
+
+	return PromptWidgetPool.GetOrCreateInstance(TSubclassOf<UUserWidget>(LoadedClass));
+}
+
+void UInteractionPromptWidgetSubsystem::ReleasePromptWidget(UUserWidget* Widget)
+{
+	if (Widget)
+	{
+		PromptWidgetPool.Release(Widget);
+	}
+}
+
+void UInteractionPromptWidgetSubsystem::OnWidgetClassLoaded(TSoftClassPtr<UUserWidget> WidgetClass)
+{
+	PendingLoads.Remove(WidgetClass.ToSoftObjectPath());
+
+	TSubclassOf<UUserWidget> LoadedClass = WidgetClass.Get();
+	if (LoadedClass == nullptr)
+	{
+		return;
+	}
+
+	LoadedWidgetClasses.AddUnique(LoadedClass);
+	PrewarmPool(LoadedClass);
+}
+
+void UInteractionPromptWidgetSubsystem::PrewarmPool(TSubclassOf<UUserWidget> WidgetClass)
+{
+	// We can't create widgets without an owning player
+	if (WidgetClass == nullptr || !UpdatePoolOwner())
+	{
+		return;
+	}
+
+	const int32 NumWidgets = UInteractionCoreSettings::Get()->PrewarmedPromptWidgetsPerClass;
+
+	// Acquiring reuses inactive widgets first, so this only creates what's missing
+	TArray<UUserWidget*, TInlineAllocator<4>> PrewarmedWidgets;
+	for (int32 WidgetIdx = 0; WidgetIdx < NumWidgets; ++WidgetIdx)
+	{
+		PrewarmedWidgets.Add(PromptWidgetPool.GetOrCreateInstance(WidgetClass));
+	}
+
+	for (UUserWidget* Widget : PrewarmedWidgets)
+	{
+		PromptWidgetPool.Release(Widget);
+	}
+}
+
+bool UInteractionPromptWidgetSubsystem::UpdatePoolOwner()
+{
+	const ULocalPlayer* LocalPlayer = GetLocalPlayer();
+	APlayerController* PlayerController = LocalPlayer ? LocalPlayer->GetPlayerController(nullptr) : nullptr;
+	if (PlayerController == nullptr)
+	{
+		return false;
+	}
+
+	if (PoolOwner == PlayerController)
+	{
+		return true;
+	}
+
+	// The pooled widgets belong to the previous controller (and possibly world), so start over
+	PromptWidgetPool.ResetPool();
+	PromptWidgetPool.SetWorld(PlayerController->GetWorld());
+	PromptWidgetPool.SetDefaultPlayerController(PlayerController);
+	PoolOwner = PlayerController;
+
+	for (const TSubclassOf<UUserWidget>& WidgetClass : LoadedWidgetClasses)
+	{
+		PrewarmPool(WidgetClass);
+	}
+
+	return true;
+}
@@ -0,0 +1,60 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+
+#include "InteractionQuery.h"
+
+#include "AbilitySystemComponent.h"
+#include "AbilitySystemGlobals.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/Pawn.h"
+#include "GenericTeamAgentInterface.h"
+#include "InteractionCoreSettings.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(InteractionQuery)
+
+void FInteractionQuery::CompileCategoryFilter()
+{
+	CategoryFilter = UInteractionCoreSettings::Get()->MakeCategoryFilter(IncludeCategories, ExcludeCategories);
+}
+
+void FInteractionQuery::BuildSnapshot(UAbilitySystemComponent* AbilitySystem, const FInteractionTagBits* OwnedTags)
+{
+	APawn* Pawn = RequestingPawn.Get();
+	AController* Controller = RequestingController.Get();
+
+	const AActor* Avatar = Pawn;
+	if (Avatar == nullptr && AbilitySystem)
+	{
+		Avatar = AbilitySystem->GetAvatarActor();
+	}
+
+	RequestingAbilitySystem = AbilitySystem ? AbilitySystem : UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Avatar);
+	AvatarLocation = Avatar ? Avatar->GetActorLocation() : FVector::ZeroVector;
+
+	FRotator ViewRotation = FRotator::ZeroRotator;
+	ViewLocation = AvatarLocation;
+	if (Controller)
+	{
+		Controller->GetPlayerViewPoint(ViewLocation, ViewRotation);
+	}
+	else if (Avatar)
+	{
+		Avatar->GetActorEyesViewPoint(ViewLocation, ViewRotation);
+	}
+	ViewDirection = ViewRotation.Vector();
+
+	// The controller usually owns the team, but AI and simple setups often only put it on the pawn
+	const IGenericTeamAgentInterface* TeamAgent = Cast<IGenericTeamAgentInterface>(Controller);
+	if (TeamAgent == nullptr)
+	{
+		TeamAgent = Cast<IGenericTeamAgentInterface>(Avatar);
+	}
+	RequestingTeamId = TeamAgent ? TeamAgent->GetGenericTeamId().GetId() : FGenericTeamId::NoTeam.GetId();
+
+	if (OwnedTags)
+	{
+		RequestingTags = *OwnedTags;
+	}
+
+	bHasSnapshot = true;
+}
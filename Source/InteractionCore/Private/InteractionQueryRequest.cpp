@@ -0,0 +1,249 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+
+#include "InteractionQueryRequest.h"
+
+#include "AbilitySystemComponent.h"
+#include "CollisionQueryParams.h"
+#include "Engine/World.h"
+#include "InteractableIndexSubsystem.h"
+#include "InteractionClaimSubsystem.h"
+#include "InteractionCoreStats.h"
+#include "InteractionStatics.h"
+#include "Interfaces/IInteractableTarget.h"
+#include "WorldCollision.h"
+
+#include <atomic>
+
+namespace InteractionQueryRequest
+{
+	/** Everything the stages of a request share, kept alive by the stages that still need it */
+	struct FRequestState
+	{
+		FInteractionQueryRequest Request;
+		TWeakObjectPtr<UWorld> World;
+
+		/** The entries each cell found, every cell query only writes to its own slot */
+		TArray<TArray<FInteractableIndexEntry>> CellEntries;
+
+		/** The entries of all cells, sorted by distance */
+		TArray<FInteractableIndexEntry> Entries;
+
+		/** The hit of the trace */
+		FHitResult TraceHit;
+	};
+
+	/**
+	 * Triggers the event of a trace once its delegate ran. If the world goes away first the delegate is dropped without
+	 * running, which releases the completion and triggers the event anyway, so the gather never waits forever.
+	 */
+	struct FTraceCompletion
+	{
+		FTraceCompletion()
+			: Event(UE_SOURCE_LOCATION)
+		{
+		}
+
+		~FTraceCompletion()
+		{
+			Trigger();
+		}
+
+		void Trigger()
+		{
+			if (!bTriggered.exchange(true))
+			{
+				Event.Trigger();
+			}
+		}
+
+		UE::Tasks::FTaskEvent Event;
+		std::atomic<bool> bTriggered{false};
+	};
+
+	/** Queries every index cell intersecting the sphere on its own worker, then merges the results on another one */
+	static UE::Tasks::FTask LaunchSphereQuery(const UInteractableIndexSubsystem* IndexSubsystem, const TSharedRef<FRequestState>& State)
+	{
+		const FInteractionQueryRequest& Request = State->Request;
+
+		TArray<TSharedPtr<const FInteractableIndexCell>> Cells;
+		if (IndexSubsystem)
+		{
+			IndexSubsystem->GetCellsInSphere(Request.Location, Request.Radius, Cells);
+		}
+
+		State->CellEntries.SetNum(Cells.Num());
+
+		TArray<UE::Tasks::FTask> CellTasks;
+		CellTasks.Reserve(Cells.Num());
+		for (int32 CellIdx = 0; CellIdx < Cells.Num(); ++CellIdx)
+		{
+			CellTasks.Add(UE::Tasks::Launch(UE_SOURCE_LOCATION, [State, Cell = Cells[CellIdx], CellIdx]()
+			{
+				const FInteractionQueryRequest& Request = State->Request;
+				Cell->CopyEntriesInSphere(Request.Location, Request.Radius, Request.Query.CategoryFilter, State->CellEntries[CellIdx]);
+			}));
+		}
+
+		return UE::Tasks::Launch(UE_SOURCE_LOCATION, [State]()
+		{
+			for (TArray<FInteractableIndexEntry>& CellEntries : State->CellEntries)
+			{
+				State->Entries.Append(MoveTemp(CellEntries));
+			}
+			State->CellEntries.Empty();
+
+			// Entries aren't capped yet, some of their targets may be gone by the time the options are gathered
+			const FVector Location = State->Request.Location;
+			State->Entries.Sort([&Location](const FInteractableIndexEntry& A, const FInteractableIndexEntry& B)
+			{
+				return FVector::DistSquared(Location, A.Location) < FVector::DistSquared(Location, B.Location);
+			});
+		}, CellTasks);
+	}
+
+	/** Starts an async trace through the physics scene, returns the event triggered once it finished */
+	static UE::Tasks::FTaskEvent LaunchLineTrace(UWorld* World, const TSharedRef<FRequestState>& State)
+	{
+		const FInteractionQueryRequest& Request = State->Request;
+		const TSharedRef<FTraceCompletion> Completion = MakeShared<FTraceCompletion>();
+
+		FCollisionQueryParams Params(SCENE_QUERY_STAT(InteractionQueryRequest), false);
+		if (const AActor* IgnoredActor = Request.IgnoredActor.Get())
+		{
+			Params.AddIgnoredActor(IgnoredActor);
+		}
+
+		FTraceDelegate TraceDelegate = FTraceDelegate::CreateLambda([State, Completion](const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+		{
+			if (TraceDatum.OutHits.Num() > 0)
+			{
+				State->TraceHit = TraceDatum.OutHits[0];
+			}
+
+			Completion->Trigger();
+		});
+
+		INC_DWORD_STAT(STAT_InteractionTraces);
+		World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Request.Location, Request.TraceEnd, Request.TraceChannel, Params, FCollisionResponseParams::DefaultResponseParam, &TraceDelegate);
+
+		return Completion->Event;
+	}
+
+	/** Gathers and filters the options of everything the query found, has to run on the game thread */
+	static TArray<FInteractionOption> GatherOptions(FRequestState& State)
+	{
+		check(IsInGameThread());
+
+		TArray<FInteractionOption> Options;
+
+		const UWorld* World = State.World.Get();
+		UAbilitySystemComponent* AbilitySystem = State.Request.AbilitySystem.Get();
+		if (World == nullptr || AbilitySystem == nullptr)
+		{
+			return Options;
+		}
+
+		TArray<TPair<TScriptInterface<IInteractableTarget>, int32>> Targets;
+		if (State.Request.Shape == EInteractionQueryRequestShape::LineTrace)
+		{
+			TArray<TScriptInterface<IInteractableTarget>> HitTargets;
+			UInteractionStatics::AppendInteractableTargetsFromHitResult(State.TraceHit, HitTargets);
+
+			const int32 InstanceIndex = UInteractionStatics::GetInteractableInstanceIndexFromHitResult(State.TraceHit);
+			for (const TScriptInterface<IInteractableTarget>& Target : HitTargets)
+			{
+				Targets.Emplace(Target, InstanceIndex);
+			}
+		}
+		else
+		{
+			for (const FInteractableIndexEntry& Entry : State.Entries)
+			{
+				if (Targets.Num() >= State.Request.MaxInteractables)
+				{
+					break;
+				}
+
+				// Skip interactables that were destroyed without being unregistered
+				if (TScriptInterface<IInteractableTarget> Target = Entry.GetInteractableTarget())
+				{
+					Targets.Emplace(Target, Entry.InstanceIndex);
+				}
+			}
+		}
+
+		if (Targets.Num() == 0)
+		{
+			return Options;
+		}
+
+		FInteractionQuery& Query = State.Request.Query;
+		if (!Query.RequestingTags.IsSet())
+		{
+			// A single request isn't worth keeping owned tag bits up to date for, so they are built once
+			Query.RequestingTags = FInteractionTagBits::MakeFromTags(AbilitySystem->GetOwnedGameplayTags(), true);
+		}
+
+		if (!Query.bHasSnapshot)
+		{
+			Query.BuildSnapshot(AbilitySystem);
+		}
+
+		const UInteractionClaimSubsystem* ClaimSubsystem = UInteractionClaimSubsystem::Get(World);
+
+		for (const TPair<TScriptInterface<IInteractableTarget>, int32>& Target : Targets)
+		{
+			TArray<FInteractionOption> TargetOptions;
+			FInteractionOptionsBuilder Builder(Target.Key, TargetOptions, Target.Value, Query.RequestingTags.GetPtrOrNull());
+			Target.Key->GatherInteractionOptions(Query, Builder);
+
+			for (FInteractionOption& Option : TargetOptions)
+			{
+				if (ClaimSubsystem && ClaimSubsystem->IsClaimedByOther(Option.InteractableTarget.GetObject(), Option.InteractableInstanceIndex, AbilitySystem))
+				{
+					continue;
+				}
+
+				if (UInteractionStatics::ResolveInteractionOptionAbility(AbilitySystem, Option))
+				{
+					Options.Add(MoveTemp(Option));
+				}
+			}
+		}
+
+		return Options;
+	}
+}
+
+UE::Tasks::TTask<TArray<FInteractionOption>> FInteractionQueryRequest::Launch(UWorld* World) const
+{
+	check(IsInGameThread());
+
+	if (World == nullptr)
+	{
+		return UE::Tasks::MakeCompletedTask<TArray<FInteractionOption>>();
+	}
+
+	const TSharedRef<InteractionQueryRequest::FRequestState> State = MakeShared<InteractionQueryRequest::FRequestState>();
+	State->Request = *this;
+	State->Request.Query.CompileCategoryFilter();
+	State->World = World;
+
+	const auto GatherOptions = [State]()
+	{
+		return InteractionQueryRequest::GatherOptions(*State);
+	};
+
+	// Everything before the gather stays away from UObjects, the gather itself runs with the game thread tasks
+	if (Shape == EInteractionQueryRequestShape::LineTrace)
+	{
+		const UE::Tasks::FTaskEvent TraceEvent = InteractionQueryRequest::LaunchLineTrace(World, State);
+		return UE::Tasks::Launch(UE_SOURCE_LOCATION, GatherOptions, UE::Tasks::Prerequisites(TraceEvent),
+			UE::Tasks::ETaskPriority::Normal, UE::Tasks::EExtendedTaskPriority::GameThreadNormalPri);
+	}
+
+	const UE::Tasks::FTask SphereQuery = InteractionQueryRequest::LaunchSphereQuery(UInteractableIndexSubsystem::Get(World), State);
+	return UE::Tasks::Launch(UE_SOURCE_LOCATION, GatherOptions, UE::Tasks::Prerequisites(SphereQuery),
+		UE::Tasks::ETaskPriority::Normal, UE::Tasks::EExtendedTaskPriority::GameThreadNormalPri);
+}
@@ -0,0 +1,286 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+
+#include "InteractionScanSubsystem.h"
+
+#include "AbilitySystemComponent.h"
+#include "AbilitySystemGlobals.h"
+#include "InteractionCoreSettings.h"
+#include "InteractionFrameBudget.h"
+#include "GameFramework/Pawn.h"
+#include "Interfaces/IInteractionScanner.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(InteractionScanSubsystem)
+
+UInteractionScanSubsystem::UInteractionScanSubsystem()
+{
+}
+
+UInteractionScanSubsystem* UInteractionScanSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+	return World ? UWorld::GetSubsystem<UInteractionScanSubsystem>(World) : nullptr;
+}
+
+void UInteractionScanSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Drop any scanners that were unregistered or destroyed since the last tick
+	RegisteredScanners.RemoveAllSwap([](const FRegisteredScanner& Entry)
+	{
+		return !Entry.Scanner.IsValid();
+	});
+
+	// Caches of previous frames are never hit again
+	for (auto It = TraceCaches.CreateIterator(); It; ++It)
+	{
+		if (It->Value.IsStale())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	if (RegisteredScanners.Num() == 0)
+	{
+		return;
+	}
+
+	const UInteractionCoreSettings* Settings = UInteractionCoreSettings::Get();
+	const double CurrentTime = GetWorld()->GetTimeSeconds();
+
+	// Gather all due scanners, overdue scanners slowly gain significance so they can't starve
+	DueScanners.Reset();
+	for (int32 ScannerIdx = 0; ScannerIdx < RegisteredScanners.Num(); ++ScannerIdx)
+	{
+		const FRegisteredScanner& Entry = RegisteredScanners[ScannerIdx];
+		if (Entry.NextScanTime <= CurrentTime)
+		{
+			const float Overdue = static_cast<float>(CurrentTime - Entry.NextScanTime);
+			DueScanners.Emplace(Entry.Significance + Overdue * Settings->OverdueSignificancePerSecond, ScannerIdx);
+		}
+	}
+
+	if (DueScanners.Num() == 0)
+	{
+		return;
+	}
+
+	// Most significant scanners go first
+	DueScanners.Sort([](const TPair<float, int32>& A, const TPair<float, int32>& B)
+	{
+		return A.Key > B.Key;
+	});
+
+	const int32 NumScans = Settings->MaxScansPerFrame > 0
+		? FMath::Min(Settings->MaxScansPerFrame, DueScanners.Num())
+		: DueScanners.Num();
+
+	FInteractionFrameBudget& FrameBudget = FInteractionFrameBudget::Get();
+
+	int32 DueIdx = 0;
+	for (; DueIdx < NumScans; ++DueIdx)
+	{
+		// Out of budget, the remaining scanners stay due and keep gaining significance until it's their turn
+		if (!FrameBudget.HasBudget(EInteractionBudgetCategory::Scans))
+		{
+			break;
+		}
+
+		// Scanning may register or unregister scanners, so never hold on to a reference across the scan
+		const int32 ScannerIdx = DueScanners[DueIdx].Value;
+		IInteractionScanner* Scanner = RegisteredScanners[ScannerIdx].Scanner.Get();
+		if (Scanner == nullptr)
+		{
+			continue;
+		}
+
+		{
+			FInteractionBudgetScope BudgetScope(EInteractionBudgetCategory::Scans);
+			Scanner->PerformInteractionScan();
+		}
+
+		if (RegisteredScanners[ScannerIdx].Scanner.IsValid())
+		{
+			UpdateScannerSchedule(RegisteredScanners[ScannerIdx], CurrentTime);
+		}
+	}
+
+	// Scanners past MaxScansPerFrame are deferred just like those the budget ran out for
+	if (DueIdx < DueScanners.Num())
+	{
+		FrameBudget.ReportDeferred(EInteractionBudgetCategory::Scans, DueScanners.Num() - DueIdx);
+	}
+}
+
+TStatId UInteractionScanSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UInteractionScanSubsystem, STATGROUP_Tickables);
+}
+
+void UInteractionScanSubsystem::RegisterScanner(UObject* Scanner, bool bScanImmediately)
+{
+	check(Scanner);
+
+	TWeakInterfacePtr<IInteractionScanner> ScannerPtr(Scanner);
+	if (!ensureMsgf(ScannerPtr.IsValid(), TEXT("%s doesn't implement IInteractionScanner"), *GetNameSafe(Scanner)))
+	{
+		return;
+	}
+
+	for (const FRegisteredScanner& Entry : RegisteredScanners)
+	{
+		if (Entry.Scanner == ScannerPtr)
+		{
+			return;
+		}
+	}
+
+	const double CurrentTime = GetWorld()->GetTimeSeconds();
+
+	FRegisteredScanner& NewEntry = RegisteredScanners.AddDefaulted_GetRef();
+	NewEntry.Scanner = ScannerPtr;
+	NewEntry.NextScanTime = bScanImmediately ? CurrentTime : CurrentTime + ScannerPtr->GetInteractionScanRate();
+}
+
+void UInteractionScanSubsystem::UnregisterScanner(UObject* Scanner)
+{
+	// Only reset the entry here, it gets removed on the next tick. This keeps indices stable while scanning.
+	for (FRegisteredScanner& Entry : RegisteredScanners)
+	{
+		if (Entry.Scanner.GetObject() == Scanner)
+		{
+			Entry.Scanner.Reset();
+		}
+	}
+}
+
+bool UInteractionScanSubsystem::FindLatestScanResult(
+	const AActor* Avatar, double MaxAge, FInteractionScanResult& OutResult) const
+{
+	const double MinScanTime = GetWorld()->GetTimeSeconds() - MaxAge;
+
+	bool bFoundResult = false;
+	for (const FRegisteredScanner& Entry : RegisteredScanners)
+	{
+		const IInteractionScanner* Scanner = Entry.Scanner.Get();
+		if (Scanner == nullptr)
+		{
+			continue;
+		}
+
+		FInteractionScanResult Result;
+		if (!Scanner->GetLastInteractionScanResult(Result) || Result.Avatar != Avatar)
+		{
+			continue;
+		}
+
+		if (Result.ScanTime < MinScanTime || (bFoundResult && Result.ScanTime <= OutResult.ScanTime))
+		{
+			continue;
+		}
+
+		OutResult = MoveTemp(Result);
+		bFoundResult = true;
+	}
+
+	return bFoundResult;
+}
+
+FInteractionTraceCache& UInteractionScanSubsystem::GetTraceCache(const AActor* Avatar)
+{
+	return TraceCaches.FindOrAdd(Avatar);
+}
+
+EInteractionScanSignificance UInteractionScanSubsystem::GetScannerSignificance(const UObject* Scanner) const
+{
+	for (const FRegisteredScanner& Entry : RegisteredScanners)
+	{
+		if (Entry.Scanner.GetObject() == Scanner)
+		{
+			return Entry.Tier;
+		}
+	}
+
+	return EInteractionScanSignificance::High;
+}
+
+float UInteractionScanSubsystem::ComputeSignificance(const FInteractionScanSignificanceInputs& Inputs)
+{
+	const UInteractionCoreSettings* Settings = UInteractionCoreSettings::Get();
+
+	float Significance = 0.f;
+
+	const APawn* Pawn = Cast<APawn>(Inputs.Avatar);
+	if (Pawn && Pawn->IsLocallyControlled())
+	{
+		Significance += Settings->LocalPlayerSignificance;
+	}
+
+	if (Inputs.bPromptShown)
+	{
+		Significance += Settings->PromptShownSignificance;
+	}
+
+	if (Settings->ProximitySignificanceRange > 0.f && Inputs.NearestInteractableDistance < Settings->ProximitySignificanceRange)
+	{
+		const float Proximity = 1.f - (Inputs.NearestInteractableDistance / Settings->ProximitySignificanceRange);
+		Significance += Settings->ProximitySignificance * Proximity;
+	}
+
+	if (Settings->InCombatTag.IsValid())
+	{
+		const UAbilitySystemComponent* ASC = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Inputs.Avatar);
+		if (ASC && ASC->HasMatchingGameplayTag(Settings->InCombatTag))
+		{
+			Significance -= Settings->InCombatSignificancePenalty;
+		}
+	}
+
+	return FMath::Max(Significance, 0.f);
+}
+
+EInteractionScanSignificance UInteractionScanSubsystem::GetSignificanceTier(float Significance)
+{
+	const UInteractionCoreSettings* Settings = UInteractionCoreSettings::Get();
+
+	if (Significance >= Settings->HighSignificanceThreshold)
+	{
+		return EInteractionScanSignificance::High;
+	}
+
+	if (Significance >= Settings->MediumSignificanceThreshold)
+	{
+		return EInteractionScanSignificance::Medium;
+	}
+
+	return EInteractionScanSignificance::Low;
+}
+
+float UInteractionScanSubsystem::GetSignificanceIntervalScale(EInteractionScanSignificance Tier)
+{
+	const UInteractionCoreSettings* Settings = UInteractionCoreSettings::Get();
+
+	switch (Tier)
+	{
+	case EInteractionScanSignificance::Medium:
+		return Settings->MediumSignificanceIntervalScale;
+	case EInteractionScanSignificance::Low:
+		return Settings->LowSignificanceIntervalScale;
+	default:
+		return 1.f;
+	}
+}
+
+void UInteractionScanSubsystem::UpdateScannerSchedule(FRegisteredScanner& Entry, double CurrentTime) const
+{
+	IInteractionScanner* Scanner = Entry.Scanner.Get();
+	check(Scanner);
+
+	FInteractionScanSignificanceInputs Inputs;
+	Scanner->GetInteractionScanSignificanceInputs(Inputs);
+
+	Entry.Significance = ComputeSignificance(Inputs);
+	Entry.Tier = GetSignificanceTier(Entry.Significance);
+	Entry.NextScanTime = CurrentTime + Scanner->GetInteractionScanRate() * GetSignificanceIntervalScale(Entry.Tier);
+}
@@ -3,8 +3,16 @@
 
 #include "InteractionStatics.h"
 
+#include "AbilitySystemComponent.h"
+#include "Components/InstancedInteractableComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
 #include "Components/PrimitiveComponent.h"
 #include "Engine/OverlapResult.h"
+#include "GameFramework/LightWeightInstanceSubsystem.h"
+#include "InteractableIndexSubsystem.h"
+#include "InteractableIndexTypes.h"
+#include "InteractionCoreSettings.h"
+#include "InteractionOption.h"
 #include "Interfaces/IInteractableTarget.h"
 #include "UObject/ScriptInterface.h"
 
@@ -55,6 +63,48 @@ void UInteractionStatics::GetInteractableTargetsFromActor(
 	}
 }
 
+void UInteractionStatics::FindNearestInteractables(
+	const UObject* WorldContextObject, FVector Location, float MaxDistance, int32 MaxCount,
+	const FGameplayTagContainer& IncludeCategories, const FGameplayTagContainer& ExcludeCategories,
+	TArray<TScriptInterface<IInteractableTarget>>& OutInteractableTargets, TArray<int32>& OutInstanceIndices)
+{
+	OutInteractableTargets.Reset();
+	OutInstanceIndices.Reset();
+
+	const UInteractableIndexSubsystem* IndexSubsystem = UInteractableIndexSubsystem::Get(WorldContextObject);
+	if (IndexSubsystem == nullptr)
+	{
+		return;
+	}
+
+	TArray<FInteractableIndexEntry> Entries;
+	IndexSubsystem->FindNearestInteractables(Location, MaxDistance, MaxCount, Entries,
+		UInteractionCoreSettings::Get()->MakeCategoryFilter(IncludeCategories, ExcludeCategories));
+
+	for (const FInteractableIndexEntry& Entry : Entries)
+	{
+		if (TScriptInterface<IInteractableTarget> Interactable = Entry.GetInteractableTarget())
+		{
+			OutInteractableTargets.Add(Interactable);
+			OutInstanceIndices.Add(Entry.InstanceIndex);
+		}
+	}
+}
+
+bool UInteractionStatics::ValidateInteraction(
+	const AActor* Instigator, const TScriptInterface<IInteractableTarget>& InteractableTarget, int32 InstanceIndex,
+	double ServerWorldTime, float MaxRange, bool bCheckLineOfSight)
+{
+	// Without an index there is nothing to validate against, so leave it to the ability
+	const UInteractableIndexSubsystem* IndexSubsystem = UInteractableIndexSubsystem::Get(Instigator);
+	if (IndexSubsystem == nullptr)
+	{
+		return true;
+	}
+
+	return IndexSubsystem->ValidateInteraction(Instigator, InteractableTarget.GetObject(), InstanceIndex, ServerWorldTime, MaxRange, bCheckLineOfSight);
+}
+
 void UInteractionStatics::AppendInteractableTargetsFromOverlapResults(
 	const TArray<FOverlapResult>& OverlapResults, TArray<TScriptInterface<IInteractableTarget>>& OutInteractableTargets)
 {
@@ -71,12 +121,30 @@ void UInteractionStatics::AppendInteractableTargetsFromOverlapResults(
 		{
 			OutInteractableTargets.Add(InteractableComponent);
 		}
+
+		// Instanced interactables are gathered for all their instances here, so only add each of them once
+		const TScriptInterface<IInteractableTarget> InstancedInteractable(UInstancedInteractableComponent::FindForInstancedComponent(Cast<UInstancedStaticMeshComponent>(Overlap.GetComponent())));
+		if (InstancedInteractable)
+		{
+			OutInteractableTargets.AddUnique(InstancedInteractable);
+		}
 	}
 }
 
 void UInteractionStatics::AppendInteractableTargetsFromHitResult(
 	const FHitResult& HitResult, TArray<TScriptInterface<IInteractableTarget>>& OutInteractableTargets)
 {
+	// Light weight instances are resolved through their manager, so we don't have to convert the instance into a full actor
+	const FActorInstanceHandle& HitObjectHandle = HitResult.HitObjectHandle;
+	if (HitObjectHandle.IsValid() && !HitObjectHandle.IsActorValid())
+	{
+		if (AActor* Manager = FLightWeightInstanceSubsystem::Get().FindLightWeightInstanceManager(HitObjectHandle))
+		{
+			GetInteractableTargetsFromActor(Manager, OutInteractableTargets);
+		}
+		return;
+	}
+
 	const TScriptInterface<IInteractableTarget> InteractableActor(HitResult.GetActor());
 	if (InteractableActor)
 	{
@@ -88,4 +156,101 @@ void UInteractionStatics::AppendInteractableTargetsFromHitResult(
 	{
 		OutInteractableTargets.Add(InteractableComponent);
 	}
+
+	const TScriptInterface<IInteractableTarget> InstancedInteractable(UInstancedInteractableComponent::FindForInstancedComponent(Cast<UInstancedStaticMeshComponent>(HitResult.GetComponent())));
+	if (InstancedInteractable)
+	{
+		OutInteractableTargets.Add(InstancedInteractable);
+	}
+}
+
+int32 UInteractionStatics::GetInteractableInstanceIndexFromHitResult(const FHitResult& HitResult)
+{
+	const FActorInstanceHandle& HitObjectHandle = HitResult.HitObjectHandle;
+	if (HitObjectHandle.IsValid() && !HitObjectHandle.IsActorValid())
+	{
+		return HitObjectHandle.GetInstanceIndex();
+	}
+
+	if (HitResult.GetComponent() && HitResult.GetComponent()->IsA<UInstancedStaticMeshComponent>())
+	{
+		return HitResult.Item;
+	}
+
+	return INDEX_NONE;
+}
+
+void UInteractionStatics::MakeHitResultFromIndexEntry(
+	const FInteractableIndexEntry& Entry, const FVector& Start, const FVector& End, double Distance, FHitResult& OutHitResult)
+{
+	const FVector Direction = (End - Start).GetSafeNormal();
+	const FVector Location = Start + Direction * Distance;
+	const double Length = FVector::Dist(Start, End);
+
+	OutHitResult = FHitResult(Location, Location, Location, -Direction);
+	OutHitResult.bBlockingHit = true;
+	OutHitResult.TraceStart = Start;
+	OutHitResult.TraceEnd = End;
+	OutHitResult.Distance = static_cast<float>(Distance);
+	OutHitResult.Time = Length > 0.0 ? static_cast<float>(Distance / Length) : 0.f;
+	OutHitResult.Location = Location;
+	OutHitResult.ImpactPoint = Location;
+
+	UObject* Target = Entry.Target.Get();
+	if (AActor* Actor = Cast<AActor>(Target))
+	{
+		OutHitResult.HitObjectHandle = FActorInstanceHandle(Actor);
+		OutHitResult.Component = Cast<UPrimitiveComponent>(Actor->GetRootComponent());
+	}
+	else if (UInstancedInteractableComponent* InstancedInteractable = Cast<UInstancedInteractableComponent>(Target))
+	{
+		// Hit the instance itself, so the adapter resolves the instance exactly like for a physics hit
+		OutHitResult.HitObjectHandle = FActorInstanceHandle(InstancedInteractable->GetOwner());
+		OutHitResult.Component = InstancedInteractable->GetInstancedComponent();
+		OutHitResult.Item = Entry.InstanceIndex;
+	}
+	else if (UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(Target))
+	{
+		OutHitResult.HitObjectHandle = FActorInstanceHandle(Primitive->GetOwner());
+		OutHitResult.Component = Primitive;
+		OutHitResult.Item = Entry.InstanceIndex;
+	}
+	else if (const UActorComponent* Component = Cast<UActorComponent>(Target))
+	{
+		OutHitResult.HitObjectHandle = FActorInstanceHandle(Component->GetOwner());
+	}
+}
+
+bool UInteractionStatics::ResolveInteractionOptionAbility(UAbilitySystemComponent* AbilitySystem, FInteractionOption& Option)
+{
+	if (AbilitySystem == nullptr)
+	{
+		return false;
+	}
+
+	FGameplayAbilitySpec* InteractionAbilitySpec = nullptr;
+
+	// if there is a handle and a target ability system, we're triggering the ability on the target.
+	if (Option.TargetAbilitySystem && Option.TargetInteractionAbilityHandle.IsValid())
+	{
+		// Find the spec
+		InteractionAbilitySpec = Option.TargetAbilitySystem->FindAbilitySpecFromHandle(Option.TargetInteractionAbilityHandle);
+	}
+
+	// If there is an interaction ability, then we're activating it on ourselves.
+	else if (const TSubclassOf<UGameplayAbility> AbilityToGrant = Option.GetInteractionAbilityToGrant())
+	{
+		// Find the spec
+		InteractionAbilitySpec = AbilitySystem->FindAbilitySpecFromClass(AbilityToGrant);
+
+		if (InteractionAbilitySpec)
+		{
+			// update the option
+			Option.TargetAbilitySystem = AbilitySystem;
+			Option.TargetInteractionAbilityHandle = InteractionAbilitySpec->Handle;
+		}
+	}
+
+	return InteractionAbilitySpec && InteractionAbilitySpec->Ability
+		&& InteractionAbilitySpec->Ability->CanActivateAbility(InteractionAbilitySpec->Handle, AbilitySystem->AbilityActorInfo.Get());
 }
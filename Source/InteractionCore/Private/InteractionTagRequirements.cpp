@@ -0,0 +1,137 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+
+#include "InteractionTagRequirements.h"
+
+#include "AbilitySystemComponent.h"
+#include "GameplayTagsManager.h"
+#include "GameplayTagsModule.h"
+#include "Misc/DelayedAutoRegister.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(InteractionTagRequirements)
+
+namespace InteractionTagBits
+{
+	/** Starts at 1, so 0 can mean "never built" */
+	static uint32 TagUniverseSerial = 1;
+
+	static FDelayedAutoRegisterHelper RegisterTagTreeChanged(EDelayedRegisterRunPhase::ObjectSystemReady, []()
+	{
+		// Network indices are reassigned whenever the tag tree is rebuilt
+		IGameplayTagsModule::OnGameplayTagTreeChanged.AddLambda([]()
+		{
+			++TagUniverseSerial;
+		});
+	});
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// FInteractionTagBits
+
+FInteractionTagBits FInteractionTagBits::MakeFromTags(const FGameplayTagContainer& Tags, bool bIncludeParents)
+{
+	FInteractionTagBits TagBits;
+
+	if (bIncludeParents)
+	{
+		for (const FGameplayTag& Tag : Tags.GetGameplayTagParents())
+		{
+			TagBits.AddTag(Tag);
+		}
+	}
+	else
+	{
+		for (const FGameplayTag& Tag : Tags)
+		{
+			TagBits.AddTag(Tag);
+		}
+	}
+
+	return TagBits;
+}
+
+void FInteractionTagBits::AddTag(const FGameplayTag& Tag)
+{
+	const FGameplayTagNetIndex NetIndex = UGameplayTagsManager::Get().GetNetIndexFromTag(Tag);
+	if (NetIndex == INVALID_TAGNETINDEX)
+	{
+		return;
+	}
+
+	const int32 WordIdx = NetIndex / 64;
+	if (WordIdx >= Words.Num())
+	{
+		Words.SetNumZeroed(WordIdx + 1);
+	}
+
+	Words[WordIdx] |= uint64(1) << (NetIndex % 64);
+}
+
+uint32 FInteractionTagBits::GetTagUniverseSerial()
+{
+	return InteractionTagBits::TagUniverseSerial;
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// FInteractionTagRequirements
+
+void FInteractionTagRequirements::Compile() const
+{
+	// Required tags have to be owned exactly (or as a parent of an owned tag), so no parents here
+	RequiredTagBits = FInteractionTagBits::MakeFromTags(RequiredTags, false);
+	BlockedTagBits = FInteractionTagBits::MakeFromTags(BlockedTags, false);
+	CompiledSerial = FInteractionTagBits::GetTagUniverseSerial();
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// FInteractionOwnedTagBits
+
+FInteractionOwnedTagBits::~FInteractionOwnedTagBits()
+{
+	Reset();
+}
+
+const FInteractionTagBits& FInteractionOwnedTagBits::Get(UAbilitySystemComponent* AbilitySystem)
+{
+	if (BoundAbilitySystem.Get() != AbilitySystem)
+	{
+		Reset();
+
+		if (AbilitySystem)
+		{
+			BoundAbilitySystem = AbilitySystem;
+			TagChangedHandle = AbilitySystem->RegisterGenericGameplayTagEvent().AddRaw(this, &FInteractionOwnedTagBits::OnTagChanged);
+		}
+	}
+
+	if (bDirty || BuiltSerial != FInteractionTagBits::GetTagUniverseSerial())
+	{
+		bDirty = false;
+		BuiltSerial = FInteractionTagBits::GetTagUniverseSerial();
+
+		// Parents are included, so owning a child tag satisfies a requirement on its parent like HasTag does
+		Bits = AbilitySystem
+			? FInteractionTagBits::MakeFromTags(AbilitySystem->GetOwnedGameplayTags(), true)
+			: FInteractionTagBits();
+	}
+
+	return Bits;
+}
+
+void FInteractionOwnedTagBits::Reset()
+{
+	if (UAbilitySystemComponent* AbilitySystem = BoundAbilitySystem.Get())
+	{
+		AbilitySystem->RegisterGenericGameplayTagEvent().Remove(TagChangedHandle);
+	}
+
+	BoundAbilitySystem.Reset();
+	TagChangedHandle.Reset();
+	Bits.Reset();
+	bDirty = true;
+}
+
+void FInteractionOwnedTagBits::OnTagChanged(const FGameplayTag Tag, int32 NewCount)
+{
+	bDirty = true;
+}
@@ -0,0 +1,56 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+
+#include "InteractionTraceCache.h"
+
+#include "CollisionQueryParams.h"
+
+FInteractionTraceKey::FInteractionTraceKey(
+	const FVector& InStart, const FVector& InEnd, FName InProfileName, const FCollisionQueryParams& Params)
+	: Start(InStart)
+	, End(InEnd)
+	, ProfileName(InProfileName)
+{
+	ParamsHash = GetTypeHash(Params.bTraceComplex);
+
+	for (const auto& IgnoredActor : Params.GetIgnoredActors())
+	{
+		ParamsHash = HashCombineFast(ParamsHash, GetTypeHash(IgnoredActor));
+	}
+
+	for (const auto& IgnoredComponent : Params.GetIgnoredComponents())
+	{
+		ParamsHash = HashCombineFast(ParamsHash, GetTypeHash(IgnoredComponent));
+	}
+}
+
+const FHitResult* FInteractionTraceCache::Find(const FInteractionTraceKey& Key)
+{
+	ResetIfStale();
+
+	for (const TPair<FInteractionTraceKey, FHitResult>& Entry : Entries)
+	{
+		if (Entry.Key == Key)
+		{
+			return &Entry.Value;
+		}
+	}
+
+	return nullptr;
+}
+
+void FInteractionTraceCache::Add(const FInteractionTraceKey& Key, const FHitResult& Hit)
+{
+	ResetIfStale();
+
+	Entries.Emplace(Key, Hit);
+}
+
+void FInteractionTraceCache::ResetIfStale()
+{
+	if (IsStale())
+	{
+		FrameNumber = GFrameCounter;
+		Entries.Reset();
+	}
+}
@@ -0,0 +1,154 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+
+#include "Interfaces/IInteractableTarget.h"
+
+#include "Components/PrimitiveComponent.h"
+#include "GameFramework/Actor.h"
+#include "GameplayTagAssetInterface.h"
+#include "InteractionClaimSubsystem.h"
+#include "InteractionCoreSettings.h"
+#include "InteractableIndexTypes.h"
+#include "InteractionOptionTemplateSubsystem.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(IInteractableTarget)
+
+//////////////////////////////////////////////////////////////////////////
+/// FInteractionOptionsBuilder
+
+bool FInteractionOptionsBuilder::AddInteractionOptionFromTemplate(const FGameplayTag& TemplateId) const
+{
+	const UInteractionOptionTemplateSubsystem* TemplateSubsystem = UInteractionOptionTemplateSubsystem::Get(Interactable.GetObject());
+	if (TemplateSubsystem == nullptr)
+	{
+		return false;
+	}
+
+	const FInteractionOption* TemplateOption = TemplateSubsystem->FindOptionTemplate(TemplateId);
+	if (TemplateOption == nullptr)
+	{
+		return false;
+	}
+
+	return AddInteractionOption(*TemplateOption);
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// IInteractableTarget
+
+namespace InteractableTarget
+{
+	/**
+	 * Returns the bounds of all colliding components of the actor.
+	 * Unlike AActor::GetComponentsBoundingBox this doesn't require registered components, so it also works while baking.
+	 */
+	static FBox GetCollidingComponentsBounds(const AActor* Actor)
+	{
+		FBox ActorBounds(ForceInit);
+		Actor->ForEachComponent<UPrimitiveComponent>(false, [&ActorBounds](const UPrimitiveComponent* Primitive)
+		{
+			if (Primitive->IsCollisionEnabled())
+			{
+				ActorBounds += Primitive->Bounds.GetBox();
+			}
+		});
+		return ActorBounds;
+	}
+}
+
+void IInteractableTarget::GatherInteractableIndexEntries(TArray<FInteractableIndexEntry>& OutEntries) const
+{
+	UObject* TargetObject = _getUObject();
+
+	FBox TargetBounds(ForceInit);
+	FVector TargetLocation = FVector::ZeroVector;
+	if (const USceneComponent* SceneComponent = Cast<USceneComponent>(TargetObject))
+	{
+		TargetBounds = SceneComponent->Bounds.GetBox();
+		TargetLocation = SceneComponent->GetComponentLocation();
+	}
+	else if (const AActor* Actor = Cast<AActor>(TargetObject))
+	{
+		TargetBounds = InteractableTarget::GetCollidingComponentsBounds(Actor);
+		TargetLocation = Actor->GetActorLocation();
+	}
+	else if (const UActorComponent* Component = Cast<UActorComponent>(TargetObject))
+	{
+		if (const AActor* Owner = Component->GetOwner())
+		{
+			TargetBounds = InteractableTarget::GetCollidingComponentsBounds(Owner);
+			TargetLocation = Owner->GetActorLocation();
+		}
+	}
+	else
+	{
+		// Not a spatial object, nothing to index
+		return;
+	}
+
+	FGameplayTagContainer CategoryTags;
+	GetInteractableCategoryTags(CategoryTags);
+
+	FInteractableIndexEntry& Entry = OutEntries.AddDefaulted_GetRef();
+	Entry.Target = TargetObject;
+	Entry.Bounds = TargetBounds;
+	Entry.Location = TargetBounds.IsValid ? TargetBounds.GetCenter() : TargetLocation;
+	Entry.CategoryMask = UInteractionCoreSettings::Get()->MakeCategoryMask(CategoryTags);
+	Entry.OptionTemplateId = GetInteractableOptionTemplateId();
+}
+
+void IInteractableTarget::GatherInteractableInstanceIndexEntries(int32 InstanceIndex, TArray<FInteractableIndexEntry>& OutEntries) const
+{
+	TArray<FInteractableIndexEntry> Entries;
+	GatherInteractableIndexEntries(Entries);
+
+	for (const FInteractableIndexEntry& Entry : Entries)
+	{
+		if (Entry.InstanceIndex == InstanceIndex)
+		{
+			OutEntries.Add(Entry);
+		}
+	}
+}
+
+void IInteractableTarget::GetInteractableCategoryTags(FGameplayTagContainer& OutTags) const
+{
+	const UObject* TargetObject = _getUObject();
+
+	const IGameplayTagAssetInterface* TagInterface = Cast<IGameplayTagAssetInterface>(TargetObject);
+	if (TagInterface == nullptr)
+	{
+		if (const UActorComponent* Component = Cast<UActorComponent>(TargetObject))
+		{
+			TagInterface = Cast<IGameplayTagAssetInterface>(Component->GetOwner());
+		}
+	}
+
+	if (TagInterface)
+	{
+		TagInterface->GetOwnedGameplayTags(OutTags);
+	}
+}
+
+bool IInteractableTarget::TryClaimInteraction(const UObject* Claimant, int32 InstanceIndex, float Duration) const
+{
+	const UObject* TargetObject = _getUObject();
+	UInteractionClaimSubsystem* ClaimSubsystem = UInteractionClaimSubsystem::Get(TargetObject);
+	return ClaimSubsystem && ClaimSubsystem->TryClaim(TargetObject, InstanceIndex, Claimant, Duration);
+}
+
+void IInteractableTarget::ReleaseInteractionClaim(const UObject* Claimant, int32 InstanceIndex) const
+{
+	const UObject* TargetObject = _getUObject();
+	if (UInteractionClaimSubsystem* ClaimSubsystem = UInteractionClaimSubsystem::Get(TargetObject))
+	{
+		ClaimSubsystem->Release(TargetObject, InstanceIndex, Claimant);
+	}
+}
+
+bool IInteractableTarget::IsInteractionClaimedByOther(const UObject* Claimant, int32 InstanceIndex) const
+{
+	const UObject* TargetObject = _getUObject();
+	const UInteractionClaimSubsystem* ClaimSubsystem = UInteractionClaimSubsystem::Get(TargetObject);
+	return ClaimSubsystem && ClaimSubsystem->IsClaimedByOther(TargetObject, InstanceIndex, Claimant);
+}
@@ -4,25 +4,47 @@
 #include "Tasks/AbilityTask_GrantNearbyInteraction.h"
 
 #include "AbilitySystemComponent.h"
+#include "InteractableIndexSubsystem.h"
+#include "InteractionAbilityStreamingSubsystem.h"
+#include "InteractionCoreSettings.h"
+#include "InteractionCoreStats.h"
+#include "InteractionFrameBudget.h"
+#include "InteractionOptionTemplateSubsystem.h"
+#include "InteractionPromptWidgetSubsystem.h"
 #include "InteractionQuery.h"
+#include "InteractionScanSubsystem.h"
 #include "InteractionStatics.h"
 #include "Interfaces/IInteractableTarget.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(AbilityTask_GrantNearbyInteraction)
 
+namespace InteractionGrants
+{
+	/** Priority of grants for interactables in range */
+	static constexpr float InRangePriority = 1.f;
+
+	/** Priority of grants for interactables ahead of the avatar */
+	static constexpr float PredictedPriority = 0.f;
+}
+
 UAbilityTask_GrantNearbyInteraction::UAbilityTask_GrantNearbyInteraction(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
+	// Ticks to work off the deferred grants
+	bTickingTask = true;
 }
 
 UAbilityTask_GrantNearbyInteraction* UAbilityTask_GrantNearbyInteraction::GrantAbilitiesForNearbyInteractors(
-	UGameplayAbility* OwningAbility, ECollisionChannel Channel, float InteractionScanRange, float InteractionScanRate, bool bShowDebug)
+	UGameplayAbility* OwningAbility, ECollisionChannel Channel, float InteractionScanRange, float InteractionScanRate, bool bShowDebug,
+	const FGameplayTagContainer& IncludeCategories, const FGameplayTagContainer& ExcludeCategories)
 {
 	UAbilityTask_GrantNearbyInteraction* NewTask = NewAbilityTask<UAbilityTask_GrantNearbyInteraction>(OwningAbility);
 	NewTask->InteractionScanRange = InteractionScanRange;
 	NewTask->InteractionScanRate = InteractionScanRate;
 	NewTask->Channel = Channel;
 	NewTask->bShowDebug = bShowDebug;
+	NewTask->IncludeCategories = IncludeCategories;
+	NewTask->ExcludeCategories = ExcludeCategories;
 	return NewTask;
 }
 
@@ -30,22 +52,75 @@ void UAbilityTask_GrantNearbyInteraction::Activate()
 {
 	SetWaitingOnAvatar();
 
-	const UWorld* World = GetWorld();
-	check(World);
+	UInteractionScanSubsystem* ScanSubsystem = UInteractionScanSubsystem::Get(this);
+	check(ScanSubsystem);
+
+	ScanSubsystem->RegisterScanner(this);
+
+	// Soft-referenced abilities are granted once they streamed in
+	if (UInteractionAbilityStreamingSubsystem* StreamingSubsystem = UInteractionAbilityStreamingSubsystem::Get(this))
+	{
+		AbilityStreamedHandle = StreamingSubsystem->OnAbilityClassStreamed.AddUObject(this, &ThisClass::OnAbilityClassStreamed);
+	}
+
+	CategoryFilter = UInteractionCoreSettings::Get()->MakeCategoryFilter(IncludeCategories, ExcludeCategories);
 
-	World->GetTimerManager().SetTimer(QueryTimerHandle, this, &ThisClass::QueryInteractables, InteractionScanRate, true);
+	// Let the interactable index tell us what changed instead of polling overlaps
+	if (UInteractableIndexSubsystem* IndexSubsystem = UInteractableIndexSubsystem::Get(this))
+	{
+		IndexObserverId = IndexSubsystem->RegisterObserver(InteractionScanRange,
+			FInteractableProximityChangedDelegate::CreateUObject(this, &ThisClass::OnNearbyInteractablesChanged),
+			CategoryFilter);
+	}
 }
 
 void UAbilityTask_GrantNearbyInteraction::OnDestroy(bool bInOwnerFinished)
 {
-	if (const UWorld* World = GetWorld())
+	if (UInteractionScanSubsystem* ScanSubsystem = UInteractionScanSubsystem::Get(this))
+	{
+		ScanSubsystem->UnregisterScanner(this);
+	}
+
+	if (UInteractableIndexSubsystem* IndexSubsystem = UInteractableIndexSubsystem::Get(this))
 	{
-		World->GetTimerManager().ClearTimer(QueryTimerHandle);
+		IndexSubsystem->UnregisterObserver(IndexObserverId);
 	}
+	IndexObserverId = INDEX_NONE;
+
+	if (UInteractionAbilityStreamingSubsystem* StreamingSubsystem = UInteractionAbilityStreamingSubsystem::Get(this))
+	{
+		StreamingSubsystem->OnAbilityClassStreamed.Remove(AbilityStreamedHandle);
+	}
+	AbilityStreamedHandle.Reset();
+
+	DeferredAbilityGrants.Reset();
+	StreamingAbilityGrants.Reset();
+	PredictedInteractables.Reset();
+	PrefetchedInteractables.Reset();
 	
 	Super::OnDestroy(bInOwnerFinished);
 }
 
+void UAbilityTask_GrantNearbyInteraction::TickTask(float DeltaTime)
+{
+	Super::TickTask(DeltaTime);
+
+	GrantDeferredAbilities();
+}
+
+void UAbilityTask_GrantNearbyInteraction::PerformInteractionScan()
+{
+	INC_DWORD_STAT(STAT_InteractionScans);
+	QueryInteractables();
+}
+
+void UAbilityTask_GrantNearbyInteraction::GetInteractionScanSignificanceInputs(
+	FInteractionScanSignificanceInputs& OutInputs) const
+{
+	OutInputs.Avatar = GetAvatarActor();
+	OutInputs.NearestInteractableDistance = NearestInteractableDistance;
+}
+
 void UAbilityTask_GrantNearbyInteraction::QueryInteractables()
 {
 	UWorld* World = GetWorld();
@@ -60,32 +135,89 @@ void UAbilityTask_GrantNearbyInteraction::QueryInteractables()
 		return;
 	}
 
+	const FVector OwnerLocation = ActorOwner->GetActorLocation();
+	UInteractableIndexSubsystem* IndexSubsystem = IndexObserverId != INDEX_NONE ? UInteractableIndexSubsystem::Get(this) : nullptr;
+
+	if (IndexSubsystem)
+	{
+		// Only notifies us about changes, nearly free while nothing around us changes
+		IndexSubsystem->UpdateObserver(IndexObserverId, OwnerLocation);
+
+		// Which interactables are the nearest can change without anything entering or leaving the scan range
+		const UInteractionCoreSettings* Settings = UInteractionCoreSettings::Get();
+		if (Settings->MaxNearbyInteractablesGathered > 0 && (bNearestInteractablesDirty ||
+			FVector::DistSquared(OwnerLocation, NearestInteractablesLocation) > FMath::Square(Settings->InteractableObserverMoveTolerance)))
+		{
+			RefreshNearestInteractables(IndexSubsystem, OwnerLocation);
+		}
+
+		// Grant ahead of where we're going, so the grant has replicated by the time we get there
+		PredictNearbyInteractables(IndexSubsystem, ActorOwner);
+
+		// Stream in the soft-referenced abilities of everything around us, so they are loaded by the time we get there
+		PrefetchInteractionAbilities(IndexSubsystem, OwnerLocation);
+
+		NearestInteractableDistance = MAX_flt;
+		for (const TPair<FInteractableIndexEntryKey, FVector>& Nearby : NearbyInteractables)
+		{
+			NearestInteractableDistance = FMath::Min(NearestInteractableDistance, FVector::Dist(OwnerLocation, Nearby.Value));
+		}
+
+#if ENABLE_DRAW_DEBUG
+		if (bShowDebug)
+		{
+			DrawDebugSphere(World, OwnerLocation, InteractionScanRange, 24, NearbyInteractables.Num() > 0 ? FColor::Red : FColor::Cyan, false, InteractionScanRate);
+		}
+#endif
+		return;
+	}
+
 	FCollisionQueryParams Params(SCENE_QUERY_STAT(UAbilityTask_GrantNearbyInteraction), false);
 	TArray<FOverlapResult> OverlapResults;
-	World->OverlapMultiByChannel(OUT OverlapResults, ActorOwner->GetActorLocation(), FQuat::Identity, Channel, FCollisionShape::MakeSphere(InteractionScanRange), Params);
+	World->OverlapMultiByChannel(OUT OverlapResults, OwnerLocation, FQuat::Identity, Channel, FCollisionShape::MakeSphere(InteractionScanRange), Params);
 
 #if ENABLE_DRAW_DEBUG
 	if (bShowDebug)
 	{
 		if (OverlapResults.Num() > 0)
 		{
-			DrawDebugSphere(World, ActorOwner->GetActorLocation(), InteractionScanRange, 24, FColor::Red, false, InteractionScanRate);
+			DrawDebugSphere(World, OwnerLocation, InteractionScanRange, 24, FColor::Red, false, InteractionScanRate);
 		}
 		else
 		{
-			DrawDebugSphere(World, ActorOwner->GetActorLocation(), InteractionScanRange, 24, FColor::Cyan, false, InteractionScanRate);	
+			DrawDebugSphere(World, OwnerLocation, InteractionScanRange, 24, FColor::Cyan, false, InteractionScanRate);	
 		}
 	}
 #endif
 
+	NearestInteractableDistance = MAX_flt;
+
 	if (OverlapResults.Num() > 0)
 	{
 		TArray<TScriptInterface<IInteractableTarget>> InteractableTargets;
 		UInteractionStatics::AppendInteractableTargetsFromOverlapResults(OverlapResults, OUT InteractableTargets);
 
-		FInteractionQuery InteractionQuery;
-		InteractionQuery.RequestingController = Cast<AController>(ActorOwner->GetOwner());
-		InteractionQuery.RequestingPawn = Cast<APawn>(ActorOwner);
+		// The index filters by category for us, here the categories of every target have to be looked up
+		if (!CategoryFilter.IsEmpty())
+		{
+			const UInteractionCoreSettings* Settings = UInteractionCoreSettings::Get();
+			InteractableTargets.RemoveAll([this, Settings](const TScriptInterface<IInteractableTarget>& Interactable)
+			{
+				FGameplayTagContainer CategoryTags;
+				Interactable->GetInteractableCategoryTags(CategoryTags);
+				return !CategoryFilter.Matches(Settings->MakeCategoryMask(CategoryTags));
+			});
+		}
+
+		for (const TScriptInterface<IInteractableTarget>& Interactable : InteractableTargets)
+		{
+			if (const AActor* InteractableActor = UInteractionStatics::GetActorFromInteractableTarget(Interactable))
+			{
+				NearestInteractableDistance = FMath::Min(NearestInteractableDistance, FVector::Dist(OwnerLocation, InteractableActor->GetActorLocation()));
+			}
+		}
+
+		const FInteractionQuery InteractionQuery = MakeInteractionQuery(ActorOwner);
 
 		TArray<FInteractionOption> InteractOptions;
 		for (TScriptInterface<IInteractableTarget>& Interactable : InteractableTargets)
@@ -94,19 +226,335 @@ void UAbilityTask_GrantNearbyInteraction::QueryInteractables()
 			Interactable->GatherInteractionOptions(InteractionQuery, Builder);
 		}
 
-		// Check if any of the options need ot grand an ability to the user before being used.
-		for (FInteractionOption& Option : InteractOptions)
+		HandleNearbyInteractionOptions(InteractOptions);
+	}
+}
+
+void UAbilityTask_GrantNearbyInteraction::OnNearbyInteractablesChanged(
+	const TArray<FInteractableIndexEntry>& Entered, const TArray<FInteractableIndexEntryKey>& Exited)
+{
+	for (const FInteractableIndexEntryKey& Key : Exited)
+	{
+		NearbyInteractables.Remove(Key);
+		GatheredInteractables.Remove(Key);
+	}
+
+	// Only the nearest interactables are looked at, so wait for them to be looked up
+	if (UInteractionCoreSettings::Get()->MaxNearbyInteractablesGathered > 0)
+	{
+		bNearestInteractablesDirty |= Entered.Num() > 0 || Exited.Num() > 0;
+		return;
+	}
+
+	// Only the interactables that just came into range need to be looked at
+	for (const FInteractableIndexEntry& Entry : Entered)
+	{
+		NearbyInteractables.Add(Entry.GetKey(), Entry.Location);
+	}
+
+	GatherNearbyInteractionOptions(Entered);
+}
+
+void UAbilityTask_GrantNearbyInteraction::RefreshNearestInteractables(UInteractableIndexSubsystem* IndexSubsystem, const FVector& Location)
+{
+	bNearestInteractablesDirty = false;
+	NearestInteractablesLocation = Location;
+
+	TArray<FInteractableIndexEntry> NearestEntries;
+	IndexSubsystem->FindNearestInteractables(Location, InteractionScanRange, UInteractionCoreSettings::Get()->MaxNearbyInteractablesGathered, NearestEntries, CategoryFilter);
+
+	NearbyInteractables.Reset();
+
+	TArray<FInteractableIndexEntry> NewEntries;
+	for (const FInteractableIndexEntry& Entry : NearestEntries)
+	{
+		const FInteractableIndexEntryKey Key = Entry.GetKey();
+		NearbyInteractables.Add(Key, Entry.Location);
+
+		bool bAlreadyGathered = false;
+		GatheredInteractables.Add(Key, &bAlreadyGathered);
+		if (!bAlreadyGathered)
+		{
+			NewEntries.Add(Entry);
+		}
+	}
+
+	GatherNearbyInteractionOptions(NewEntries);
+}
+
+void UAbilityTask_GrantNearbyInteraction::GatherNearbyInteractionOptions(const TArray<FInteractableIndexEntry>& Entries, bool bPredicted)
+{
+	AActor* ActorOwner = GetAvatarActor();
+	if (ActorOwner == nullptr || Entries.Num() == 0)
+	{
+		return;
+	}
+
+	const FInteractionQuery InteractionQuery = MakeInteractionQuery(ActorOwner);
+
+	TArray<FInteractionOption> InteractOptions;
+	for (const FInteractableIndexEntry& Entry : Entries)
+	{
+		TScriptInterface<IInteractableTarget> Interactable = Entry.GetInteractableTarget();
+		if (Interactable)
+		{
+			FInteractionOptionsBuilder Builder(Interactable, InteractOptions, Entry.InstanceIndex);
+			Interactable->GatherInteractionOptions(InteractionQuery, Builder);
+		}
+	}
+
+	HandleNearbyInteractionOptions(InteractOptions, bPredicted);
+}
+
+FInteractionQuery UAbilityTask_GrantNearbyInteraction::MakeInteractionQuery(AActor* ActorOwner)
+{
+	FInteractionQuery InteractionQuery;
+	InteractionQuery.RequestingController = Cast<AController>(ActorOwner->GetOwner());
+	InteractionQuery.RequestingPawn = Cast<APawn>(ActorOwner);
+	InteractionQuery.IncludeCategories = IncludeCategories;
+	InteractionQuery.ExcludeCategories = ExcludeCategories;
+	// Options aren't filtered by their tag requirements here. Gathering only happens when interactables come into range, so an option
+	// dropped now wouldn't have its ability granted once the avatar gains the tags. The focus path filters them instead.
+	InteractionQuery.BuildSnapshot(AbilitySystemComponent.Get());
+	return InteractionQuery;
+}
+
+void UAbilityTask_GrantNearbyInteraction::HandleNearbyInteractionOptions(const TArray<FInteractionOption>& InteractOptions, bool bPredicted)
+{
+	// Start loading the prompt widgets of nearby interactables, so they are ready once the player focuses them
+	if (UInteractionPromptWidgetSubsystem* PromptWidgets = UInteractionPromptWidgetSubsystem::Get(Ability->GetCurrentActorInfo()->PlayerController.Get()))
+	{
+		PromptWidgets->PreloadWidgetClasses(InteractOptions);
+	}
+
+	// Check if any of the options need ot grand an ability to the user before being used.
+	for (const FInteractionOption& Option : InteractOptions)
+	{
+		const float Priority = bPredicted ? InteractionGrants::PredictedPriority : InteractionGrants::InRangePriority;
+		if (Option.InteractionAbilityToGrant)
+		{
+			QueueAbilityGrant(Option.InteractionAbilityToGrant, Priority);
+		}
+		else if (!Option.SoftInteractionAbilityToGrant.IsNull())
+		{
+			QueueStreamedAbilityGrant(Option.SoftInteractionAbilityToGrant, Priority);
+		}
+	}
+
+	GrantDeferredAbilities();
+}
+
+void UAbilityTask_GrantNearbyInteraction::QueueAbilityGrant(TSubclassOf<UGameplayAbility> AbilityClass, float Priority)
+{
+	if (InteractionAbilityCache.Contains(FObjectKey(AbilityClass)))
+	{
+		return;
+	}
+
+	// A predicted grant whose interactable came into range is granted with the priority of the interactable in range
+	for (FDeferredAbilityGrant& Grant : DeferredAbilityGrants)
+	{
+		if (Grant.AbilityClass == AbilityClass)
+		{
+			Grant.Priority = FMath::Max(Grant.Priority, Priority);
+			return;
+		}
+	}
+
+	FDeferredAbilityGrant& Grant = DeferredAbilityGrants.AddDefaulted_GetRef();
+	Grant.AbilityClass = AbilityClass;
+	Grant.Priority = Priority;
+}
+
+void UAbilityTask_GrantNearbyInteraction::QueueStreamedAbilityGrant(const TSoftClassPtr<UGameplayAbility>& AbilityClass, float Priority)
+{
+	UInteractionAbilityStreamingSubsystem* StreamingSubsystem = UInteractionAbilityStreamingSubsystem::Get(this);
+	if (StreamingSubsystem == nullptr)
+	{
+		return;
+	}
+
+	if (TSubclassOf<UGameplayAbility> LoadedClass = StreamingSubsystem->RequestAbilityClass(AbilityClass))
+	{
+		QueueAbilityGrant(LoadedClass, Priority);
+		return;
+	}
+
+	// Granted once it streamed in, with the highest priority it was requested with
+	float& StreamingPriority = StreamingAbilityGrants.FindOrAdd(AbilityClass.ToSoftObjectPath(), Priority);
+	StreamingPriority = FMath::Max(StreamingPriority, Priority);
+}
+
+void UAbilityTask_GrantNearbyInteraction::OnAbilityClassStreamed(const TSoftClassPtr<UGameplayAbility>& AbilityClass)
+{
+	float Priority = 0.f;
+	if (StreamingAbilityGrants.RemoveAndCopyValue(AbilityClass.ToSoftObjectPath(), Priority))
+	{
+		QueueAbilityGrant(AbilityClass.Get(), Priority);
+	}
+}
+
+void UAbilityTask_GrantNearbyInteraction::GrantDeferredAbilities()
+{
+	if (DeferredAbilityGrants.Num() == 0)
+	{
+		return;
+	}
+
+	FInteractionFrameBudget& FrameBudget = FInteractionFrameBudget::Get();
+
+	// Grants that waited the longest gain priority, so predicted grants can't starve behind interactables in range
+	DeferredAbilityGrants.StableSort([](const FDeferredAbilityGrant& A, const FDeferredAbilityGrant& B)
+	{
+		return FInteractionFrameBudget::GetAgedPriority(A.Priority, A.FramesDeferred) > FInteractionFrameBudget::GetAgedPriority(B.Priority, B.FramesDeferred);
+	});
+
+	const int32 MaxGrants = UInteractionCoreSettings::Get()->MaxInteractionAbilityGrantsPerFrame;
+
+	int32 NumGranted = 0;
+	for (; NumGranted < DeferredAbilityGrants.Num(); ++NumGranted)
+	{
+		if ((MaxGrants > 0 && NumGranted >= MaxGrants) || !FrameBudget.HasBudget(EInteractionBudgetCategory::Grants))
+		{
+			break;
+		}
+
+		const TSubclassOf<UGameplayAbility>& AbilityClass = DeferredAbilityGrants[NumGranted].AbilityClass;
+		FObjectKey ObjectKey(AbilityClass);
+		if (AbilityClass && !InteractionAbilityCache.Contains(ObjectKey))
+		{
+			FInteractionBudgetScope BudgetScope(EInteractionBudgetCategory::Grants);
+
+			FGameplayAbilitySpec Spec(AbilityClass, 1, INDEX_NONE, this);
+			FGameplayAbilitySpecHandle Handle = AbilitySystemComponent->GiveAbility(Spec);
+			InteractionAbilityCache.Add(ObjectKey, Handle);
+		}
+	}
+
+	DeferredAbilityGrants.RemoveAt(0, NumGranted, EAllowShrinking::No);
+
+	// The rest is granted over the next frames
+	if (DeferredAbilityGrants.Num() > 0)
+	{
+		for (FDeferredAbilityGrant& Grant : DeferredAbilityGrants)
+		{
+			++Grant.FramesDeferred;
+		}
+
+		FrameBudget.ReportDeferred(EInteractionBudgetCategory::Grants, DeferredAbilityGrants.Num());
+	}
+}
+
+void UAbilityTask_GrantNearbyInteraction::PredictNearbyInteractables(UInteractableIndexSubsystem* IndexSubsystem, const AActor* ActorOwner)
+{
+	const UInteractionCoreSettings* Settings = UInteractionCoreSettings::Get();
+	if (Settings->InteractionGrantPredictionTime <= 0.f || Settings->MaxPredictedInteractablesGathered <= 0)
+	{
+		return;
+	}
+
+	const FVector Velocity = ActorOwner->GetVelocity();
+	if (Velocity.IsNearlyZero())
+	{
+		return;
+	}
+
+	// Only look again once the predicted location moved noticeably
+	const FVector PredictedLocation = ActorOwner->GetActorLocation() + Velocity * Settings->InteractionGrantPredictionTime;
+	if (FVector::DistSquared(PredictedLocation, PredictedInteractablesLocation) <= FMath::Square(Settings->InteractableObserverMoveTolerance))
+	{
+		return;
+	}
+
+	PredictedInteractablesLocation = PredictedLocation;
+
+	TArray<FInteractableIndexEntry> PredictedEntries;
+	IndexSubsystem->FindNearestInteractables(PredictedLocation, InteractionScanRange, Settings->MaxPredictedInteractablesGathered, PredictedEntries, CategoryFilter);
+
+	// Only gather from interactables that are neither in range nor were predicted last time
+	TSet<FInteractableIndexEntryKey> NewPredictedInteractables;
+	TArray<FInteractableIndexEntry> NewEntries;
+	for (const FInteractableIndexEntry& Entry : PredictedEntries)
+	{
+		const FInteractableIndexEntryKey Key = Entry.GetKey();
+		NewPredictedInteractables.Add(Key);
+
+		if (!NearbyInteractables.Contains(Key) && !PredictedInteractables.Contains(Key))
+		{
+			NewEntries.Add(Entry);
+		}
+	}
+
+	PredictedInteractables = MoveTemp(NewPredictedInteractables);
+
+	GatherNearbyInteractionOptions(NewEntries, true);
+}
+
+void UAbilityTask_GrantNearbyInteraction::PrefetchInteractionAbilities(UInteractableIndexSubsystem* IndexSubsystem, const FVector& Location)
+{
+	const UInteractionCoreSettings* Settings = UInteractionCoreSettings::Get();
+	if (Settings->InteractionAbilityPrefetchRadius <= 0.f || Settings->MaxPrefetchedInteractables <= 0)
+	{
+		return;
+	}
+
+	if (FVector::DistSquared(Location, PrefetchedInteractablesLocation) <= FMath::Square(Settings->InteractableObserverMoveTolerance))
+	{
+		return;
+	}
+
+	PrefetchedInteractablesLocation = Location;
+
+	UInteractionAbilityStreamingSubsystem* StreamingSubsystem = UInteractionAbilityStreamingSubsystem::Get(this);
+	AActor* ActorOwner = GetAvatarActor();
+	if (StreamingSubsystem == nullptr || ActorOwner == nullptr)
+	{
+		return;
+	}
+
+	TArray<FInteractableIndexEntry> NearestEntries;
+	IndexSubsystem->FindNearestInteractables(Location, FMath::Max(Settings->InteractionAbilityPrefetchRadius, InteractionScanRange), Settings->MaxPrefetchedInteractables, NearestEntries, CategoryFilter);
+
+	const UInteractionOptionTemplateSubsystem* TemplateSubsystem = UInteractionOptionTemplateSubsystem::Get(this);
+	TOptional<FInteractionQuery> InteractionQuery;
+
+	TSet<FInteractableIndexEntryKey> NewPrefetchedInteractables;
+	TArray<FInteractionOption> InteractOptions;
+	for (const FInteractableIndexEntry& Entry : NearestEntries)
+	{
+		const FInteractableIndexEntryKey Key = Entry.GetKey();
+		NewPrefetchedInteractables.Add(Key);
+
+		if (PrefetchedInteractables.Contains(Key))
+		{
+			continue;
+		}
+
+		// Templated interactables tell us their ability through the template id stored in the index, without gathering their options
+		if (const FInteractionOption* TemplateOption = TemplateSubsystem && Entry.OptionTemplateId.IsValid() ? TemplateSubsystem->FindOptionTemplate(Entry.OptionTemplateId) : nullptr)
+		{
+			InteractOptions.Add(*TemplateOption);
+		}
+		else if (TScriptInterface<IInteractableTarget> Interactable = Entry.GetInteractableTarget())
 		{
-			if (Option.InteractionAbilityToGrant)
+			if (!InteractionQuery.IsSet())
 			{
-				FObjectKey ObjectKey(Option.InteractionAbilityToGrant);
-				if (!InteractionAbilityCache.Find(ObjectKey))
-				{
-					FGameplayAbilitySpec Spec(Option.InteractionAbilityToGrant, 1, INDEX_NONE, this);
-					FGameplayAbilitySpecHandle Handle = AbilitySystemComponent->GiveAbility(Spec);
-					InteractionAbilityCache.Add(ObjectKey, Handle);
-				}
+				InteractionQuery = MakeInteractionQuery(ActorOwner);
 			}
+
+			FInteractionOptionsBuilder Builder(Interactable, InteractOptions, Entry.InstanceIndex);
+			Interactable->GatherInteractionOptions(InteractionQuery.GetValue(), Builder);
+		}
+	}
+
+	PrefetchedInteractables = MoveTemp(NewPrefetchedInteractables);
+
+	// Only streamed in, granting waits until the interactables are in range or predicted to be
+	for (const FInteractionOption& Option : InteractOptions)
+	{
+		if (!Option.InteractionAbilityToGrant && !Option.SoftInteractionAbilityToGrant.IsNull())
+		{
+			StreamingSubsystem->RequestAbilityClass(Option.SoftInteractionAbilityToGrant);
 		}
 	}
 }
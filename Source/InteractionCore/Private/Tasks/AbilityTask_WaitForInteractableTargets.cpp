@@ -4,7 +4,15 @@
 #include "Tasks/AbilityTask_WaitForInteractableTargets.h"
 
 #include "AbilitySystemComponent.h"
+#include "InteractableIndexSubsystem.h"
+#include "InteractionClaimSubsystem.h"
+#include "InteractionCoreSettings.h"
+#include "InteractionCoreStats.h"
+#include "InteractionHighlightSubsystem.h"
+#include "InteractionScanSubsystem.h"
+#include "InteractionStatics.h"
 #include "Interfaces/IInteractableTarget.h"
+#include "TimerManager.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(AbilityTask_WaitForInteractableTargets)
 
@@ -13,6 +21,26 @@ struct FInteractionOptions;
 UAbilityTask_WaitForInteractableTargets::UAbilityTask_WaitForInteractableTargets(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
+	const UInteractionCoreSettings* Settings = UInteractionCoreSettings::Get();
+	BroadcastCoalesceWindow = Settings->InteractableOptionsCoalesceWindow;
+	MaxBroadcastsPerSecond = Settings->MaxInteractableOptionsBroadcastsPerSecond;
+}
+
+void UAbilityTask_WaitForInteractableTargets::OnDestroy(bool bInOwnerFinished)
+{
+	if (const UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(BroadcastTimerHandle);
+	}
+
+	if (UInteractionHighlightSubsystem* HighlightSubsystem = UInteractionHighlightSubsystem::Get(this))
+	{
+		HighlightSubsystem->ClearFocusedInteractables(this);
+	}
+
+	OwnedTagBits.Reset();
+
+	Super::OnDestroy(bInOwnerFinished);
 }
 
 void UAbilityTask_WaitForInteractableTargets::LineTrace(
@@ -23,20 +51,78 @@ void UAbilityTask_WaitForInteractableTargets::LineTrace(
 
 	OutHit = FHitResult(); // <- For failsafe
 
-	TArray<FHitResult> HitResults;
-	World->LineTraceMultiByProfile(HitResults, Start, End, ProfileName, Params);
-	
-	OutHit.TraceStart = Start;
-	OutHit.TraceEnd = End;
+	INC_DWORD_STAT(STAT_InteractionTraces);
+
+	// We only ever care about the first blocking hit, so don't pay for a multi trace
+	if (!World->LineTraceSingleByProfile(OutHit, Start, End, ProfileName, Params))
+	{
+		OutHit.TraceStart = Start;
+		OutHit.TraceEnd = End;
+	}
+}
+
+void UAbilityTask_WaitForInteractableTargets::LineTraceShared(
+	FHitResult& OutHit, const AActor* Avatar, const FVector& Start, const FVector& End,
+	FName ProfileName, const FCollisionQueryParams& Params) const
+{
+	check(Avatar);
+
+	UInteractionScanSubsystem* ScanSubsystem = UInteractionScanSubsystem::Get(Avatar);
+	if (ScanSubsystem == nullptr)
+	{
+		++NumTraces;
+		LineTrace(OutHit, Avatar->GetWorld(), Start, End, ProfileName, Params);
+		return;
+	}
+
+	const FInteractionTraceKey TraceKey(Start, End, ProfileName, Params);
+	FInteractionTraceCache& TraceCache = ScanSubsystem->GetTraceCache(Avatar);
+
+	if (const FHitResult* CachedHit = TraceCache.Find(TraceKey))
+	{
+		INC_DWORD_STAT(STAT_InteractionTraceCacheHits);
+		OutHit = *CachedHit;
+		return;
+	}
+
+	++NumTraces;
+	LineTrace(OutHit, Avatar->GetWorld(), Start, End, ProfileName, Params);
+	TraceCache.Add(TraceKey, OutHit);
+}
+
+void UAbilityTask_WaitForInteractableTargets::TraceInteractables(
+	FHitResult& OutHit, const AActor* Avatar, const FVector& Start, const FVector& End,
+	FName ProfileName, const FCollisionQueryParams& Params) const
+{
+	const UInteractableIndexSubsystem* IndexSubsystem = TraceMode != EInteractionTraceMode::PhysicsOnly ? UInteractableIndexSubsystem::Get(Avatar) : nullptr;
+	if (IndexSubsystem == nullptr)
+	{
+		LineTraceShared(OutHit, Avatar, Start, End, ProfileName, Params);
+		return;
+	}
+
+	FInteractableIndexEntry Entry;
+	double Distance;
+	if (!IndexSubsystem->RaycastInteractable(Start, End, Avatar, Entry, Distance, CategoryFilter))
+	{
+		// Nothing interactable along the trace, so there's nothing for the physics scene to confirm either
+		OutHit = FHitResult();
+		OutHit.TraceStart = Start;
+		OutHit.TraceEnd = End;
+		return;
+	}
 
-	if (HitResults.Num() > 0)
+	if (TraceMode == EInteractionTraceMode::IndexOnly)
 	{
-		OutHit = HitResults[0];
+		UInteractionStatics::MakeHitResultFromIndexEntry(Entry, Start, End, Distance, OutHit);
+		return;
 	}
+
+	LineTraceShared(OutHit, Avatar, Start, End, ProfileName, Params);
 }
 
 void UAbilityTask_WaitForInteractableTargets::AimWithPlayerController(
-	const AActor* InSourceActor, FCollisionQueryParams Params, const FVector& Start, float MaxRange, FVector& OutEnd, bool bIgnorePitch) const
+	const AActor* InSourceActor, FCollisionQueryParams Params, const FVector& Start, float MaxRange, FVector& OutEnd, bool bIgnorePitch, FHitResult* OutCameraHit) const
 {
 	// Should only run on server and local client
 	if (Ability == nullptr)
@@ -59,12 +145,17 @@ void UAbilityTask_WaitForInteractableTargets::AimWithPlayerController(
 	const FVector ViewDir = ViewRot.Vector();
 	FVector ViewEnd = ViewStart + (ViewDir * MaxRange);
 
-	ClipCameraRayToAbilityRange(ViewStart, ViewDir, Start, MaxRange, ViewEnd);
+	const bool bClippedToRange = ClipCameraRayToAbilityRange(ViewStart, ViewDir, Start, MaxRange, ViewEnd);
 
 	FHitResult Hit;
-	LineTrace(Hit, InSourceActor->GetWorld(), ViewStart, ViewEnd, TraceProfile.Name, Params);
+	TraceInteractables(Hit, InSourceActor, ViewStart, ViewEnd, TraceProfile.Name, Params);
 
 	const bool bUseTraceResult = Hit.bBlockingHit && (FVector::DistSquared(Start, Hit.Location) <= (MaxRange * MaxRange));
+
+	if (OutCameraHit && bClippedToRange && bUseTraceResult)
+	{
+		*OutCameraHit = Hit;
+	}
 	const FVector AdjustedEnd = bUseTraceResult ? Hit.Location : ViewEnd;
 
 	FVector AdjustedAimDir = (AdjustedEnd - Start).GetSafeNormal();
@@ -113,48 +204,35 @@ bool UAbilityTask_WaitForInteractableTargets::ClipCameraRayToAbilityRange(
 }
 
 void UAbilityTask_WaitForInteractableTargets::UpdateInteractableOptions(
-	const FInteractionQuery& Query, const TArray<TScriptInterface<IInteractableTarget>>& InteractableTargets)
+	const FInteractionQuery& Query, const TArray<TScriptInterface<IInteractableTarget>>& InteractableTargets, int32 InstanceIndex)
 {
 	TArray<FInteractionOption> NewOptions;
 
+	// Options the avatar doesn't meet the tag requirements of are dropped before their abilities are even looked at
+	const FInteractionTagBits* RequestingTags = Query.RequestingTags.IsSet()
+		? Query.RequestingTags.GetPtrOrNull()
+		: &OwnedTagBits.Get(AbilitySystemComponent.Get());
+
+	const UInteractionClaimSubsystem* ClaimSubsystem = UInteractionClaimSubsystem::Get(this);
+
 	for (const TScriptInterface<IInteractableTarget>& InteractiveTarget : InteractableTargets)
 	{
 		TArray<FInteractionOption> TempOptions;
-		FInteractionOptionsBuilder InteractionBuilder(InteractiveTarget, TempOptions);
+		FInteractionOptionsBuilder InteractionBuilder(InteractiveTarget, TempOptions, InstanceIndex, RequestingTags);
 		InteractiveTarget->GatherInteractionOptions(Query, InteractionBuilder);
 
 		for (FInteractionOption& Option : TempOptions)
 		{
-			FGameplayAbilitySpec* InteractionAbilitySpec = nullptr;
-
-			// if there is a handle and a target ability system, we're triggering the ability on the target.
-			if (Option.TargetAbilitySystem && Option.TargetInteractionAbilityHandle.IsValid())
-			{
-				// Find the spec
-				InteractionAbilitySpec = Option.TargetAbilitySystem->FindAbilitySpecFromHandle(Option.TargetInteractionAbilityHandle);
-			}
-			
-			// If there is an interaction ability, then we're activating it on ourselves.
-			else if (Option.InteractionAbilityToGrant)
+			// Someone else is already interacting with the target, so don't bother activating anything
+			if (ClaimSubsystem && ClaimSubsystem->IsClaimedByOther(Option.InteractableTarget.GetObject(), Option.InteractableInstanceIndex, AbilitySystemComponent.Get()))
 			{
-				// Find the spec
-				InteractionAbilitySpec = AbilitySystemComponent->FindAbilitySpecFromClass(Option.InteractionAbilityToGrant);
-
-				if (InteractionAbilitySpec)
-				{
-					// update the option
-					Option.TargetAbilitySystem = AbilitySystemComponent.Get();
-					Option.TargetInteractionAbilityHandle = InteractionAbilitySpec->Handle;
-				}
+				continue;
 			}
 
-			if (InteractionAbilitySpec)
+			// Filter any options that we can't activate right now for whatever reason.
+			if (UInteractionStatics::ResolveInteractionOptionAbility(AbilitySystemComponent.Get(), Option))
 			{
-				// Filter any options that we can't activate right now for whatever reason.
-				if (InteractionAbilitySpec->Ability->CanActivateAbility(InteractionAbilitySpec->Handle, AbilitySystemComponent->AbilityActorInfo.Get()))
-				{
-					NewOptions.Add(Option);
-				}
+				NewOptions.Add(Option);
 			}
 		}
 	}
@@ -184,6 +262,68 @@ void UAbilityTask_WaitForInteractableTargets::UpdateInteractableOptions(
 	if (bOptionsChanged)
 	{
 		CurrentOptions = NewOptions;
-		InteractableObjectsChanged.Broadcast(CurrentOptions);
+		RequestOptionsBroadcast();
+	}
+}
+
+void UAbilityTask_WaitForInteractableTargets::RequestOptionsBroadcast()
+{
+	const UWorld* World = GetWorld();
+	check(World);
+
+	FTimerManager& TimerManager = World->GetTimerManager();
+
+	// The pending broadcast will pick up the latest options
+	if (TimerManager.IsTimerActive(BroadcastTimerHandle))
+	{
+		++NumSuppressedBroadcasts;
+		INC_DWORD_STAT(STAT_InteractionOptionBroadcastsSuppressed);
+		return;
+	}
+
+	const double CurrentTime = World->GetTimeSeconds();
+
+	double BroadcastTime = CurrentTime + BroadcastCoalesceWindow;
+	if (MaxBroadcastsPerSecond > 0.f)
+	{
+		BroadcastTime = FMath::Max(BroadcastTime, LastBroadcastTime + 1.0 / MaxBroadcastsPerSecond);
+	}
+
+	if (BroadcastTime <= CurrentTime)
+	{
+		BroadcastOptions();
+		return;
+	}
+
+	TimerManager.SetTimer(BroadcastTimerHandle, this, &ThisClass::BroadcastOptions, static_cast<float>(BroadcastTime - CurrentTime), false);
+}
+
+void UAbilityTask_WaitForInteractableTargets::BroadcastOptions()
+{
+	const UWorld* World = GetWorld();
+	check(World);
+
+	World->GetTimerManager().ClearTimer(BroadcastTimerHandle);
+
+	// The options changed back within the coalescing window, nothing to tell anyone
+	if (CurrentOptions == BroadcastedOptions)
+	{
+		++NumSuppressedBroadcasts;
+		INC_DWORD_STAT(STAT_InteractionOptionBroadcastsSuppressed);
+		return;
+	}
+
+	BroadcastedOptions = CurrentOptions;
+	LastBroadcastTime = World->GetTimeSeconds();
+
+	// Shares the coalescing and focus hysteresis of the broadcast, so the highlights flicker no more than the prompts
+	if (UInteractionCoreSettings::Get()->bHighlightFocusedInteractables && IsLocallyControlled())
+	{
+		if (UInteractionHighlightSubsystem* HighlightSubsystem = UInteractionHighlightSubsystem::Get(this))
+		{
+			HighlightSubsystem->SetFocusedInteractionOptions(this, CurrentOptions);
+		}
 	}
+
+	InteractableObjectsChanged.Broadcast(CurrentOptions);
 }
@@ -3,6 +3,9 @@
 
 #include "Tasks/AbilityTask_WaitForInteractableTargets_SingleLineTrace.h"
 
+#include "InteractionCoreSettings.h"
+#include "InteractionCoreStats.h"
+#include "InteractionScanSubsystem.h"
 #include "InteractionStatics.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(AbilityTask_WaitForInteractableTargets_SingleLineTrace)
@@ -17,15 +20,18 @@ UAbilityTask_WaitForInteractableTargets_SingleLineTrace* UAbilityTask_WaitForInt
 WaitForInteractableTargets_SingleLineTrace(
 	UGameplayAbility* OwningAbility, FInteractionQuery InteractionQuery,
 	FCollisionProfileName TraceProfile, FGameplayAbilityTargetingLocationInfo StartLocation,
-	float InteractionScanRange,float InteractionScanRate, bool bShowDebug)
+	float InteractionScanRange,float InteractionScanRate, bool bShowDebug, EInteractionTraceMode TraceMode)
 {
 	UAbilityTask_WaitForInteractableTargets_SingleLineTrace* NewTask = NewAbilityTask<UAbilityTask_WaitForInteractableTargets_SingleLineTrace>(OwningAbility);
 	NewTask->InteractionScanRate = InteractionScanRate;
 	NewTask->InteractionScanRange = InteractionScanRange;
 	NewTask->StartLocation = StartLocation;
 	NewTask->InteractionQuery = InteractionQuery;
+	NewTask->InteractionQuery.CompileCategoryFilter();
+	NewTask->CategoryFilter = NewTask->InteractionQuery.CategoryFilter;
 	NewTask->TraceProfile = TraceProfile;
 	NewTask->bShowDebug = bShowDebug;
+	NewTask->TraceMode = TraceMode;
 	return NewTask;
 }
 
@@ -33,22 +39,51 @@ void UAbilityTask_WaitForInteractableTargets_SingleLineTrace::Activate()
 {
 	SetWaitingOnAvatar();
 
-	const UWorld* World = GetWorld();
-	check(World);
+	UInteractionScanSubsystem* ScanSubsystem = UInteractionScanSubsystem::Get(this);
+	check(ScanSubsystem);
 
-	World->GetTimerManager().SetTimer(TimerHandle, this, &ThisClass::PerformTrace, InteractionScanRate, true);
+	ScanSubsystem->RegisterScanner(this);
 }
 
 void UAbilityTask_WaitForInteractableTargets_SingleLineTrace::OnDestroy(bool bInOwnerFinished)
 {
-	if (const UWorld* World = GetWorld())
+	if (UInteractionScanSubsystem* ScanSubsystem = UInteractionScanSubsystem::Get(this))
 	{
-		World->GetTimerManager().ClearTimer(TimerHandle);
+		ScanSubsystem->UnregisterScanner(this);
 	}
 	
 	Super::OnDestroy(bInOwnerFinished);
 }
 
+void UAbilityTask_WaitForInteractableTargets_SingleLineTrace::PerformInteractionScan()
+{
+	INC_DWORD_STAT(STAT_InteractionScans);
+	PerformTrace();
+}
+
+void UAbilityTask_WaitForInteractableTargets_SingleLineTrace::GetInteractionScanSignificanceInputs(
+	FInteractionScanSignificanceInputs& OutInputs) const
+{
+	OutInputs.Avatar = GetAvatarActor();
+	OutInputs.NearestInteractableDistance = NearestInteractableDistance;
+	OutInputs.bPromptShown = CurrentOptions.Num() > 0;
+}
+
+bool UAbilityTask_WaitForInteractableTargets_SingleLineTrace::GetLastInteractionScanResult(
+	FInteractionScanResult& OutResult) const
+{
+	if (LastScanTime < 0.0)
+	{
+		return false;
+	}
+
+	OutResult.Avatar = GetAvatarActor();
+	OutResult.Hit = LastScanHit;
+	OutResult.Options = CurrentOptions;
+	OutResult.ScanTime = LastScanTime;
+	return true;
+}
+
 void UAbilityTask_WaitForInteractableTargets_SingleLineTrace::PerformTrace()
 {
 	AActor* Avatar = Ability->GetCurrentActorInfo()->AvatarActor.Get();
@@ -68,15 +103,48 @@ void UAbilityTask_WaitForInteractableTargets_SingleLineTrace::PerformTrace()
 
 	const FVector TraceStart = StartLocation.GetTargetingTransform().GetLocation();
 	FVector TraceEnd;
-	AimWithPlayerController(Avatar, Params, TraceStart, InteractionScanRange, OUT TraceEnd);
-
 	FHitResult OutHit;
-	LineTrace(OutHit, World, TraceStart, TraceEnd, TraceProfile.Name, Params);
+	AimWithPlayerController(Avatar, Params, TraceStart, InteractionScanRange, OUT TraceEnd, false, &OutHit);
 
+	// If the camera ray already landed on an interactable within range, there's no need to trace again from the start location
 	TArray<TScriptInterface<IInteractableTarget>> InteractableTargets;
-	UInteractionStatics::AppendInteractableTargetsFromHitResult(OutHit, InteractableTargets);
+	if (OutHit.bBlockingHit)
+	{
+		UInteractionStatics::AppendInteractableTargetsFromHitResult(OutHit, InteractableTargets);
+	}
+
+	if (InteractableTargets.Num() == 0)
+	{
+		TraceInteractables(OutHit, Avatar, TraceStart, TraceEnd, TraceProfile.Name, Params);
+		UInteractionStatics::AppendInteractableTargetsFromHitResult(OutHit, InteractableTargets);
+	}
+
+	const UObject* HitTarget = InteractableTargets.Num() > 0 ? InteractableTargets[0].GetObject() : nullptr;
+	const int32 HitInstanceIndex = HitTarget ? UInteractionStatics::GetInteractableInstanceIndexFromHitResult(OutHit) : INDEX_NONE;
+
+	if (UpdateFocus(HitTarget, HitInstanceIndex, World->GetTimeSeconds()))
+	{
+		FocusTarget = HitTarget;
+		FocusInstanceIndex = HitInstanceIndex;
+		FocusHit = OutHit;
+	}
+	else
+	{
+		// Stick with the focused interactable until the new one proves itself
+		OutHit = FocusHit;
+		InteractableTargets.Reset();
+		UInteractionStatics::AppendInteractableTargetsFromHitResult(OutHit, InteractableTargets);
+	}
+
+	// Measured from the avatar, the hit may come from the camera ray or be the focus hit of an earlier scan
+	NearestInteractableDistance = InteractableTargets.Num() > 0 ? FVector::Dist(Avatar->GetActorLocation(), OutHit.ImpactPoint) : MAX_flt;
+	LastScanHit = OutHit;
+	LastScanTime = World->GetTimeSeconds();
 	
-	UpdateInteractableOptions(InteractionQuery, InteractableTargets);
+	// Resolved once here, so the targets can read it instead of looking it up themselves
+	InteractionQuery.BuildSnapshot(AbilitySystemComponent.Get(), &OwnedTagBits.Get(AbilitySystemComponent.Get()));
+
+	UpdateInteractableOptions(InteractionQuery, InteractableTargets, InteractableTargets.Num() > 0 ? FocusInstanceIndex : INDEX_NONE);
 
 #if ENABLE_DRAW_DEBUG
 	if (bShowDebug)
@@ -94,3 +162,85 @@ void UAbilityTask_WaitForInteractableTargets_SingleLineTrace::PerformTrace()
 	}
 #endif
 }
+
+bool UAbilityTask_WaitForInteractableTargets_SingleLineTrace::UpdateFocus(
+	const UObject* HitTarget, int32 HitInstanceIndex, double CurrentTime)
+{
+	const UInteractionCoreSettings* Settings = UInteractionCoreSettings::Get();
+	const int32 HistorySize = FMath::Max(Settings->FocusHistorySize, 1);
+
+	FFocusSample NewSample;
+	NewSample.Target = HitTarget;
+	NewSample.InstanceIndex = HitInstanceIndex;
+
+	if (FocusHistory.Num() < HistorySize)
+	{
+		NextFocusSampleIndex = FocusHistory.Add(NewSample) + 1;
+	}
+	else
+	{
+		NextFocusSampleIndex %= FocusHistory.Num();
+		FocusHistory[NextFocusSampleIndex++] = NewSample;
+	}
+
+	if (NewSample.IsSameFocus(FocusTarget.Get(), FocusInstanceIndex))
+	{
+		CandidateTarget.Reset();
+		CandidateInstanceIndex = INDEX_NONE;
+		return true;
+	}
+
+	// Looking away releases focus right away, holding on would keep showing the prompt of something the player doesn't look at
+	const UObject* CurrentFocus = FocusTarget.Get();
+	if (HitTarget == nullptr || CurrentFocus == nullptr)
+	{
+		CandidateTarget.Reset();
+		CandidateInstanceIndex = INDEX_NONE;
+		return true;
+	}
+
+	// The dwell time is measured from when the candidate was first hit without interruption, regardless of the history size
+	if (CandidateTarget.Get() != HitTarget || CandidateInstanceIndex != HitInstanceIndex)
+	{
+		CandidateTarget = HitTarget;
+		CandidateInstanceIndex = HitInstanceIndex;
+		CandidateStartTime = CurrentTime;
+	}
+
+	const bool bUseDwellTime = Settings->FocusSwitchDwellTime > 0.f;
+	const bool bUseScoreMargin = Settings->FocusSwitchScoreMargin > 0.f;
+	if (!bUseDwellTime && !bUseScoreMargin)
+	{
+		return true;
+	}
+
+	if (bUseDwellTime && CurrentTime - CandidateStartTime >= Settings->FocusSwitchDwellTime)
+	{
+		return true;
+	}
+
+	if (bUseScoreMargin)
+	{
+		int32 NumCandidateSamples = 0;
+		int32 NumFocusSamples = 0;
+		for (const FFocusSample& Sample : FocusHistory)
+		{
+			if (Sample.IsSameFocus(HitTarget, HitInstanceIndex))
+			{
+				++NumCandidateSamples;
+			}
+			else if (Sample.IsSameFocus(CurrentFocus, FocusInstanceIndex))
+			{
+				++NumFocusSamples;
+			}
+		}
+
+		const float ScoreMargin = static_cast<float>(NumCandidateSamples - NumFocusSamples) / HistorySize;
+		if (ScoreMargin >= Settings->FocusSwitchScoreMargin)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,50 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+
+#include "Tests/InteractionCoreTestTypes.h"
+
+#include "Data/InteractableIndexLevelData.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "InteractableIndexTypes.h"
+#include "Misc/AutomationTest.h"
+#include "NativeGameplayTags.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
+
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_InteractionCoreTest_OptionTemplate, "InteractionCore.Test.OptionTemplate");
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInteractableIndexBakeOptionTemplateTest, "InteractionCore.InteractableIndex.BakeOptionTemplateId",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FInteractableIndexBakeOptionTemplateTest::RunTest(const FString& Parameters)
+{
+	UWorld* World = UWorld::CreateWorld(EWorldType::Editor, false);
+	if (!TestNotNull(TEXT("World"), World))
+	{
+		return false;
+	}
+
+	AInteractionCoreTestInteractable* Interactable = World->SpawnActor<AInteractionCoreTestInteractable>();
+	Interactable->OptionTemplateId = TAG_InteractionCoreTest_OptionTemplate;
+
+	UInteractableIndexLevelData::BakeLevel(World->PersistentLevel);
+
+	const UInteractableIndexLevelData* LevelData = World->PersistentLevel->GetAssetUserData<UInteractableIndexLevelData>();
+	if (TestNotNull(TEXT("Baked level data"), LevelData))
+	{
+		TArray<FInteractableIndexEntry> Entries;
+		LevelData->AppendEntries(Entries);
+
+		if (TestEqual(TEXT("Number of baked entries"), Entries.Num(), 1))
+		{
+			TestTrue(TEXT("Baked entry belongs to the interactable"), Entries[0].Target.Get() == Interactable);
+			TestEqual(TEXT("Baked option template id"), Entries[0].OptionTemplateId, FGameplayTag(TAG_InteractionCoreTest_OptionTemplate));
+		}
+	}
+
+	World->DestroyWorld(false);
+	return true;
+}
+
+#endif
@@ -0,0 +1,53 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+
+#include "InteractableIndexTypes.h"
+#include "InteractionCoreSettings.h"
+#include "Misc/AutomationTest.h"
+#include "NativeGameplayTags.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_InteractionCoreTest_Category, "InteractionCore.Test.Category");
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_InteractionCoreTest_Category_Child, "InteractionCore.Test.Category.Child");
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_InteractionCoreTest_Unconfigured, "InteractionCore.Test.Unconfigured");
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInteractionCategoryFilterTest, "InteractionCore.InteractableIndex.CategoryFilter",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FInteractionCategoryFilterTest::RunTest(const FString& Parameters)
+{
+	UInteractionCoreSettings* Settings = GetMutableDefault<UInteractionCoreSettings>();
+	const TArray<FGameplayTag> SavedCategories = Settings->InteractableCategories;
+	Settings->InteractableCategories = { TAG_InteractionCoreTest_Category };
+
+	// Both tags that don't stand for a configured category are reported
+	AddExpectedError(TEXT("is not a configured interactable category"), EAutomationExpectedErrorFlags::Contains, 2);
+
+	const uint64 CategoryMask = Settings->MakeCategoryMask(FGameplayTagContainer(TAG_InteractionCoreTest_Category));
+	const uint64 ChildMask = Settings->MakeCategoryMask(FGameplayTagContainer(TAG_InteractionCoreTest_Category_Child));
+	TestEqual(TEXT("Interactables with a child tag are part of the category"), ChildMask, CategoryMask);
+
+	// Asking only for a tag that isn't a category must not widen to everything
+	const FInteractableCategoryFilter UnconfiguredFilter = Settings->MakeCategoryFilter(FGameplayTagContainer(TAG_InteractionCoreTest_Unconfigured), FGameplayTagContainer());
+	TestFalse(TEXT("Unconfigured include rejects uncategorized interactables"), UnconfiguredFilter.Matches(0));
+	TestFalse(TEXT("Unconfigured include rejects categorized interactables"), UnconfiguredFilter.Matches(CategoryMask));
+
+	// Asking for a child tag must not widen to its parent category
+	const FInteractableCategoryFilter ChildFilter = Settings->MakeCategoryFilter(FGameplayTagContainer(TAG_InteractionCoreTest_Category_Child), FGameplayTagContainer());
+	TestFalse(TEXT("Child include rejects the parent category"), ChildFilter.Matches(CategoryMask));
+
+	// Asking for a parent tag includes the categories below it
+	const FInteractableCategoryFilter ParentFilter = Settings->MakeCategoryFilter(FGameplayTagContainer(FGameplayTag::RequestGameplayTag(TEXT("InteractionCore.Test"))), FGameplayTagContainer());
+	TestTrue(TEXT("Parent include accepts the categories below it"), ParentFilter.Matches(CategoryMask));
+	TestFalse(TEXT("Parent include rejects uncategorized interactables"), ParentFilter.Matches(0));
+
+	// Excluding a tag that isn't a category excludes nothing
+	const FInteractableCategoryFilter ExcludeFilter = Settings->MakeCategoryFilter(FGameplayTagContainer(), FGameplayTagContainer(TAG_InteractionCoreTest_Unconfigured));
+	TestTrue(TEXT("Unconfigured exclude accepts categorized interactables"), ExcludeFilter.Matches(CategoryMask));
+
+	Settings->InteractableCategories = SavedCategories;
+	return true;
+}
+
+#endif
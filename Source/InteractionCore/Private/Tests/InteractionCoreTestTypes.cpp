@@ -0,0 +1,43 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+
+#include "Tests/InteractionCoreTestTypes.h"
+
+#include "AbilitySystemComponent.h"
+#include "Components/BoxComponent.h"
+#include "Components/SceneComponent.h"
+#include "Engine/CollisionProfile.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(InteractionCoreTestTypes)
+
+AInteractionCoreTestInteractable::AInteractionCoreTestInteractable()
+{
+	// Static, so the cooker would bake it
+	UBoxComponent* CollisionBox = CreateDefaultSubobject<UBoxComponent>(TEXT("CollisionBox"));
+	CollisionBox->SetMobility(EComponentMobility::Static);
+	CollisionBox->SetBoxExtent(FVector(50.f));
+	CollisionBox->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+	RootComponent = CollisionBox;
+}
+
+void AInteractionCoreTestInteractable::GatherInteractionOptions(const FInteractionQuery& Query, FInteractionOptionsBuilder& OptionsBuilder)
+{
+	if (OptionTemplateId.IsValid())
+	{
+		OptionsBuilder.AddInteractionOptionFromTemplate(OptionTemplateId);
+	}
+}
+
+AInteractionCoreTestPawn::AInteractionCoreTestPawn()
+{
+	// Views from the pawn location, not above it
+	BaseEyeHeight = 0.f;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("SceneRoot"));
+	AbilitySystemComponent = CreateDefaultSubobject<UAbilitySystemComponent>(TEXT("AbilitySystemComponent"));
+}
+
+UInteractionCoreTestAbility::UInteractionCoreTestAbility()
+{
+	InstancingPolicy = EGameplayAbilityInstancingPolicy::InstancedPerActor;
+}
@@ -0,0 +1,58 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "Abilities/GameplayAbility.h"
+#include "AbilitySystemInterface.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/Pawn.h"
+#include "Interfaces/IInteractableTarget.h"
+
+#include "InteractionCoreTestTypes.generated.h"
+
+class UAbilitySystemComponent;
+
+/** Minimal interactable actor used by the automation tests of this module, blocking every trace within its box. */
+UCLASS(NotBlueprintable, NotPlaceable, Transient, HideDropdown)
+class AInteractionCoreTestInteractable : public AActor, public IInteractableTarget
+{
+	GENERATED_BODY()
+
+public:
+	AInteractionCoreTestInteractable();
+
+	//~ Begin IInteractableTarget Interface
+	virtual void GatherInteractionOptions(const FInteractionQuery& Query, FInteractionOptionsBuilder& OptionsBuilder) override;
+	virtual FGameplayTag GetInteractableOptionTemplateId() const override { return OptionTemplateId; }
+	//~ End IInteractableTarget Interface
+
+	/** The template reported to the interactable index */
+	FGameplayTag OptionTemplateId;
+};
+
+/** Pawn with an ability system, used as the avatar of the automation tests of this module. */
+UCLASS(NotBlueprintable, NotPlaceable, Transient, HideDropdown)
+class AInteractionCoreTestPawn : public APawn, public IAbilitySystemInterface
+{
+	GENERATED_BODY()
+
+public:
+	AInteractionCoreTestPawn();
+
+	//~ Begin IAbilitySystemInterface Interface
+	virtual UAbilitySystemComponent* GetAbilitySystemComponent() const override { return AbilitySystemComponent; }
+	//~ End IAbilitySystemInterface Interface
+
+	UPROPERTY()
+	TObjectPtr<UAbilitySystemComponent> AbilitySystemComponent;
+};
+
+/** Ability that does nothing by itself, the automation tests run their ability tasks on it. */
+UCLASS(NotBlueprintable, HideDropdown)
+class UInteractionCoreTestAbility : public UGameplayAbility
+{
+	GENERATED_BODY()
+
+public:
+	UInteractionCoreTestAbility();
+};
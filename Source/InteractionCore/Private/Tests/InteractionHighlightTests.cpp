@@ -0,0 +1,73 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+
+#include "Tests/InteractionCoreTestTypes.h"
+
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "InteractionCoreSettings.h"
+#include "InteractionHighlightSubsystem.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInteractionHighlightFocusTest, "InteractionCore.Highlight.Focus",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FInteractionHighlightFocusTest::RunTest(const FString& Parameters)
+{
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	if (!TestNotNull(TEXT("World"), World))
+	{
+		return false;
+	}
+
+	UInteractionHighlightSubsystem* HighlightSubsystem = UInteractionHighlightSubsystem::Get(World);
+	if (!TestNotNull(TEXT("Highlight subsystem"), HighlightSubsystem))
+	{
+		World->DestroyWorld(false);
+		return false;
+	}
+
+	AInteractionCoreTestInteractable* Interactable = World->SpawnActor<AInteractionCoreTestInteractable>(FVector::ZeroVector, FRotator::ZeroRotator);
+	AActor* FocusOwner = World->SpawnActor<AActor>(FVector::ZeroVector, FRotator::ZeroRotator);
+
+	// Shapes are hidden in game by default, and hidden primitives are never highlighted
+	UPrimitiveComponent* Primitive = CastChecked<UPrimitiveComponent>(Interactable->GetRootComponent());
+	Primitive->SetHiddenInGame(false);
+
+	const bool bInitialRenderCustomDepth = Primitive->bRenderCustomDepth;
+	const int32 InitialStencilValue = Primitive->CustomDepthStencilValue;
+	const int32 HighlightStencilValue = UInteractionCoreSettings::Get()->HighlightStencilValue;
+
+	HighlightSubsystem->SetFocusedInteractables(FocusOwner, { Interactable });
+	HighlightSubsystem->FlushHighlights();
+
+	TestTrue(TEXT("Focused primitive is highlighted"), HighlightSubsystem->IsHighlighted(Primitive));
+	TestTrue(TEXT("Focused primitive renders custom depth"), Primitive->bRenderCustomDepth);
+	TestEqual(TEXT("Focused primitive stencil value"), Primitive->CustomDepthStencilValue, HighlightStencilValue);
+
+	HighlightSubsystem->ClearFocusedInteractables(FocusOwner);
+	HighlightSubsystem->FlushHighlights();
+
+	TestFalse(TEXT("Unfocused primitive is no longer highlighted"), HighlightSubsystem->IsHighlighted(Primitive));
+	TestEqual(TEXT("Unfocused primitive custom depth is restored"), Primitive->bRenderCustomDepth, bInitialRenderCustomDepth);
+	TestEqual(TEXT("Unfocused primitive stencil value is restored"), Primitive->CustomDepthStencilValue, InitialStencilValue);
+
+	// An owner that goes away without clearing its focus doesn't leave the highlight behind, even though the focus never changes again
+	HighlightSubsystem->SetFocusedInteractables(FocusOwner, { Interactable });
+	HighlightSubsystem->FlushHighlights();
+	TestTrue(TEXT("Refocused primitive is highlighted"), HighlightSubsystem->IsHighlighted(Primitive));
+
+	FocusOwner->Destroy();
+	HighlightSubsystem->Tick(0.f);
+
+	TestFalse(TEXT("Primitive of a destroyed focus owner is no longer highlighted"), HighlightSubsystem->IsHighlighted(Primitive));
+	TestEqual(TEXT("Primitive of a destroyed focus owner custom depth is restored"), Primitive->bRenderCustomDepth, bInitialRenderCustomDepth);
+	TestEqual(TEXT("Primitive of a destroyed focus owner stencil value is restored"), Primitive->CustomDepthStencilValue, InitialStencilValue);
+
+	World->DestroyWorld(false);
+	return true;
+}
+
+#endif
@@ -0,0 +1,92 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+
+#include "Tests/InteractionCoreTestTypes.h"
+
+#include "AbilitySystemComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Interfaces/IInteractionScanner.h"
+#include "Misc/AutomationTest.h"
+#include "Tasks/AbilityTask_WaitForInteractableTargets_SingleLineTrace.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInteractionScanTracesPerScanTest, "InteractionCore.Scan.TracesPerScan",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FInteractionScanTracesPerScanTest::RunTest(const FString& Parameters)
+{
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	if (!TestNotNull(TEXT("World"), World))
+	{
+		return false;
+	}
+
+	constexpr float ScanRange = 500.f;
+
+	// The scan starts below the camera, so the camera ray and the ray from the start location never share a trace cache entry
+	const FVector ViewLocation = FVector::ZeroVector;
+	const FVector ScanStart(0.f, 0.f, -20.f);
+
+	AInteractionCoreTestInteractable* Interactable = World->SpawnActor<AInteractionCoreTestInteractable>(FVector(300.f, 0.f, 0.f), FRotator::ZeroRotator);
+	AInteractionCoreTestPawn* Pawn = World->SpawnActor<AInteractionCoreTestPawn>(ViewLocation, FRotator::ZeroRotator);
+	APlayerController* PlayerController = World->SpawnActor<APlayerController>(ViewLocation, FRotator::ZeroRotator);
+	PlayerController->Possess(Pawn);
+
+	UAbilitySystemComponent* AbilitySystemComponent = Pawn->GetAbilitySystemComponent();
+	AbilitySystemComponent->InitAbilityActorInfo(Pawn, Pawn);
+
+	const FGameplayAbilitySpecHandle AbilityHandle = AbilitySystemComponent->GiveAbility(FGameplayAbilitySpec(UInteractionCoreTestAbility::StaticClass()));
+	AbilitySystemComponent->TryActivateAbility(AbilityHandle);
+
+	const FGameplayAbilitySpec* AbilitySpec = AbilitySystemComponent->FindAbilitySpecFromHandle(AbilityHandle);
+	UGameplayAbility* Ability = AbilitySpec && AbilitySpec->GetAbilityInstances().Num() > 0 ? AbilitySpec->GetAbilityInstances()[0] : nullptr;
+	if (!TestNotNull(TEXT("Activated ability"), Ability))
+	{
+		World->DestroyWorld(false);
+		return false;
+	}
+
+	FGameplayAbilityTargetingLocationInfo StartLocation;
+	StartLocation.LiteralTransform.SetLocation(ScanStart);
+
+	UAbilityTask_WaitForInteractableTargets_SingleLineTrace* Task = UAbilityTask_WaitForInteractableTargets_SingleLineTrace::WaitForInteractableTargets_SingleLineTrace(
+		Ability, FInteractionQuery(), FCollisionProfileName(UCollisionProfile::BlockAll_ProfileName), StartLocation, ScanRange);
+	Task->ReadyForActivation();
+
+	// Whatever the view point is taken from, the controller, its control rotation or the pawn, it looks along the same ray
+	auto ScanAlong = [&](const FRotator& ViewRotation)
+	{
+		Pawn->SetActorRotation(ViewRotation);
+		PlayerController->SetActorRotation(ViewRotation);
+		PlayerController->SetControlRotation(ViewRotation);
+
+		const int32 NumTracesBefore = Task->GetNumTraces();
+		Task->PerformInteractionScan();
+		return Task->GetNumTraces() - NumTracesBefore;
+	};
+
+	// Looking at the interactable, the camera hit is used as is
+	const int32 NumTracesOnInteractable = ScanAlong(FRotator::ZeroRotator);
+	TestEqual(TEXT("Traces per scan looking at an interactable"), NumTracesOnInteractable, 1);
+
+	FInteractionScanResult ScanResult;
+	if (TestTrue(TEXT("Scan result"), Task->GetLastInteractionScanResult(ScanResult)))
+	{
+		TestTrue(TEXT("Scan found the interactable"), ScanResult.Hit.GetActor() == Interactable);
+	}
+
+	// Looking away, the camera ray finds nothing and the scan traces again from its start location
+	const int32 NumTracesLookingAway = ScanAlong(FRotator(0.f, 180.f, 0.f));
+	TestEqual(TEXT("Traces per scan looking away"), NumTracesLookingAway, 2);
+
+	AddInfo(FString::Printf(TEXT("Traces per scan: %d looking at an interactable, %d looking away"), NumTracesOnInteractable, NumTracesLookingAway));
+
+	Task->EndTask();
+	World->DestroyWorld(false);
+	return true;
+}
+
+#endif
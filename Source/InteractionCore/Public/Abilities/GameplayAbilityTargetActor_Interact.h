@@ -3,6 +3,7 @@
 #pragma once
 
 #include "Abilities/GameplayAbilityTargetActor_Trace.h"
+#include "InteractionOption.h"
 
 #include "GameplayAbilityTargetActor_Interact.generated.h"
 
@@ -21,4 +22,29 @@ public:
 	//~ Begin AGameplayAbilityTargetActor_Trace Interface
 	virtual FHitResult PerformTrace(AActor* InSourceActor) override;
 	//~ End AGameplayAbilityTargetActor_Trace Interface
+
+	/** Returns the interaction options of the scan result that was reused by the last trace, empty if we traced ourselves */
+	UFUNCTION(BlueprintPure, Category = Interaction)
+	const TArray<FInteractionOption>& GetReusedScanOptions() const { return ReusedScanOptions; }
+
+protected:
+	/** Tries to take the hit of the most recent interaction scan of the source actor instead of tracing again */
+	bool TryReuseScanResult(const AActor* InSourceActor, FHitResult& OutHit);
+
+	/** Moves the reticle to the given hit */
+	void UpdateReticle(const FHitResult& Hit);
+
+public:
+	/** If true, the most recent hit of a running interaction scan task is used instead of tracing again, as long as it is fresh enough */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = Trace, meta = (ExposeOnSpawn = true))
+	bool bReuseScanResults = true;
+
+	/** The maximum age in seconds of a scan result to be reused */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = Trace, meta = (ExposeOnSpawn = true, EditCondition = "bReuseScanResults", ClampMin = 0, Units = "s"))
+	float MaxScanResultAge = 0.1f;
+
+protected:
+	/** The interaction options of the reused scan result */
+	UPROPERTY(Transient)
+	TArray<FInteractionOption> ReusedScanOptions;
 };
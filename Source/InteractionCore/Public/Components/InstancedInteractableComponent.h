@@ -0,0 +1,116 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "Components/ActorComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "InteractionOption.h"
+#include "Interfaces/IInteractableTarget.h"
+
+#include "InstancedInteractableComponent.generated.h"
+
+class UObject;
+struct FFrame;
+
+/** Compact per-instance interaction state. Kept as small as possible, as there is one entry for every instance. */
+struct FInstancedInteractableState
+{
+	FInstancedInteractableState()
+		: OptionIndex(0)
+		, bEnabled(true)
+	{
+	}
+
+	/** Index into the option list of the owning component */
+	uint8 OptionIndex;
+
+	/** Whether this instance can currently be interacted with */
+	uint8 bEnabled : 1;
+};
+
+/**
+ * Adapter that makes every instance of an instanced static mesh an interactable target.
+ * The hit instance (FHitResult::Item) is mapped to one of the options of this component,
+ * so thousands of instances can share a single component instead of needing their own actor.
+ *
+ * Also usable on light weight instance managers, in which case the light weight instance index is used.
+ * Instance states follow their instances when instances of the instanced static mesh are removed or relocated.
+ */
+UCLASS(ClassGroup = (Interaction), meta = (BlueprintSpawnableComponent))
+class INTERACTIONCORE_API UInstancedInteractableComponent : public UActorComponent, public IInteractableTarget
+{
+	GENERATED_BODY()
+
+public:
+	UInstancedInteractableComponent(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	/** Finds the instanced interactable component that drives the given instanced static mesh component. */
+	static UInstancedInteractableComponent* FindForInstancedComponent(const UInstancedStaticMeshComponent* InstancedComponent);
+
+	//~ Begin UActorComponent Interface
+	virtual void OnRegister() override;
+	virtual void OnUnregister() override;
+	//~ End UActorComponent Interface
+
+	//~ Begin IInteractableTarget Interface
+	virtual void GatherInteractionOptions(const FInteractionQuery& Query, FInteractionOptionsBuilder& OptionsBuilder) override;
+	virtual void GatherInteractableIndexEntries(TArray<FInteractableIndexEntry>& OutEntries) const override;
+	virtual void GatherInteractableInstanceIndexEntries(int32 InstanceIndex, TArray<FInteractableIndexEntry>& OutEntries) const override;
+	//~ End IInteractableTarget Interface
+
+	/** Sets the instanced static mesh component whose instances are interactable. */
+	UFUNCTION(BlueprintCallable, Category = Interaction)
+	void SetInstancedComponent(UInstancedStaticMeshComponent* InInstancedComponent);
+
+	/** Returns the instanced static mesh component whose instances are interactable. */
+	UInstancedStaticMeshComponent* GetInstancedComponent() const { return InstancedComponent; }
+
+	/** Enables or disables the interaction for a single instance. */
+	UFUNCTION(BlueprintCallable, Category = Interaction)
+	void SetInstanceEnabled(int32 InstanceIndex, bool bEnabled);
+
+	/** Returns whether a single instance can currently be interacted with. */
+	UFUNCTION(BlueprintPure, Category = Interaction)
+	bool IsInstanceEnabled(int32 InstanceIndex) const;
+
+	/** Sets which of the InstanceOptions a single instance should use. */
+	UFUNCTION(BlueprintCallable, Category = Interaction)
+	void SetInstanceOptionIndex(int32 InstanceIndex, int32 OptionIndex);
+
+	/** Returns the instance of the instanced static mesh component the given instance is rendered with, INDEX_NONE if there is none. */
+	int32 GetInstancedComponentIndex(int32 InstanceIndex) const;
+
+	/** Returns the instance of this component an instance of the instanced static mesh component belongs to, INDEX_NONE if there is none. */
+	int32 GetInstanceIndexFromInstancedComponent(int32 ComponentInstanceIndex) const;
+
+protected:
+	/** Returns the state for the given instance, growing the state array if needed. */
+	FInstancedInteractableState& GetMutableInstanceState(int32 InstanceIndex);
+
+	/** Appends the index entries of the given range of instances of the instanced static mesh component. */
+	void GatherInstancedComponentIndexEntries(int32 FirstComponentInstanceIndex, int32 EndComponentInstanceIndex, TArray<FInteractableIndexEntry>& OutEntries) const;
+
+	/** Re-registers a single instance with the interactable index after its state changed. */
+	void UpdateInstanceInIndex(int32 InstanceIndex);
+
+	/** Moves the instance states along with the instances of the instanced static mesh component. */
+	void OnInstanceIndexUpdated(UInstancedStaticMeshComponent* InInstancedComponent, TArrayView<const FInstancedStaticMeshDelegates::FInstanceIndexUpdateData> IndexUpdates);
+
+	/** Whether the instances are light weight instances of our owning manager. */
+	bool IsLightWeightInstanceManager() const;
+
+protected:
+	/** The options the instances can provide. Each instance maps to exactly one of these, the first one by default. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Interaction)
+	TArray<FInteractionOption> InstanceOptions;
+
+	/** The instanced static mesh component whose instances are interactable. Defaults to the first one found on the owner. */
+	UPROPERTY(Transient)
+	TObjectPtr<UInstancedStaticMeshComponent> InstancedComponent;
+
+	/** Per-instance state, indexed by the instance index. Instances past the end use the default state. */
+	TArray<FInstancedInteractableState> InstanceStates;
+
+	/** Handle of our binding to FInstancedStaticMeshDelegates::OnInstanceIndexUpdated */
+	FDelegateHandle InstanceIndexUpdatedHandle;
+};
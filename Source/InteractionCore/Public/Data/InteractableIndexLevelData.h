@@ -0,0 +1,96 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "Engine/AssetUserData.h"
+#include "GameplayTagContainer.h"
+
+#include "InteractableIndexLevelData.generated.h"
+
+class AActor;
+class FArchive;
+class ULevel;
+class UObject;
+struct FInteractableIndexEntry;
+
+/** Compact, trivially copyable record of a single baked interactable index entry. */
+struct FInteractableIndexBakedRecord
+{
+	/** Bitmask of the categories of the interactable */
+	uint64 CategoryMask = 0;
+
+	/** World location of the interactable */
+	FVector3f Location = FVector3f::ZeroVector;
+
+	/** World bounds of the interactable, Min > Max if the interactable has no bounds */
+	FVector3f BoundsMin = FVector3f(1.f);
+	FVector3f BoundsMax = FVector3f(-1.f);
+
+	/** Index into the baked targets */
+	int32 TargetIndex = INDEX_NONE;
+
+	/** The instance of the target, INDEX_NONE if the target isn't instanced */
+	int32 InstanceIndex = INDEX_NONE;
+
+	/** Index into the baked option template ids, INDEX_NONE if there is none */
+	int32 OptionTemplateIndex = INDEX_NONE;
+
+	friend FArchive& operator<<(FArchive& Ar, FInteractableIndexBakedRecord& Record);
+};
+
+template<> struct TCanBulkSerialize<FInteractableIndexBakedRecord> { enum { Value = true }; };
+
+/**
+ * Interactable index entries of the static interactables of a level, baked by the cooker.
+ * Added to every cooked level (and World Partition cell), so the interactable index can be filled
+ * without visiting the actors of the level.
+ */
+UCLASS()
+class INTERACTIONCORE_API UInteractableIndexLevelData : public UAssetUserData
+{
+	GENERATED_BODY()
+
+public:
+	UInteractableIndexLevelData();
+
+	//~ Begin UObject Interface
+	virtual void Serialize(FArchive& Ar) override;
+	//~ End UObject Interface
+
+	/** Appends the baked entries to the given entries */
+	void AppendEntries(TArray<FInteractableIndexEntry>& OutEntries) const;
+
+	/** Returns the interactable actors that can't be baked and have to be gathered at runtime */
+	const TArray<TObjectPtr<AActor>>& GetRuntimeActors() const { return RuntimeActors; }
+
+	/** Returns the number of baked entries */
+	int32 GetNumBakedEntries() const { return Records.Num(); }
+
+#if WITH_EDITOR
+	/** Bakes the interactables of the given level, replacing any previously baked data. Removes the data if there is nothing to bake. */
+	static void BakeLevel(ULevel* Level);
+
+	/** Removes any baked data from the given level */
+	static void RemoveFromLevel(ULevel* Level);
+#endif
+
+protected:
+	/** Returns whether the entries of the given actor can be baked, which is only the case for actors that never move */
+	static bool CanBakeActor(const AActor* Actor);
+
+protected:
+	/** All objects referenced by the baked records */
+	UPROPERTY()
+	TArray<TObjectPtr<UObject>> Targets;
+
+	/** All option template ids referenced by the baked records */
+	UPROPERTY()
+	TArray<FGameplayTag> OptionTemplateIds;
+
+	/** Interactable actors that can move, so their entries have to be gathered at runtime */
+	UPROPERTY()
+	TArray<TObjectPtr<AActor>> RuntimeActors;
+
+	/** The baked records, bulk serialized */
+	TArray<FInteractableIndexBakedRecord> Records;
+};
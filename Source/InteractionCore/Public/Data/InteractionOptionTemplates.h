@@ -0,0 +1,90 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "Engine/DataAsset.h"
+#include "GameplayTagContainer.h"
+#include "InteractionTagRequirements.h"
+
+#include "InteractionOptionTemplates.generated.h"
+
+class UGameplayAbility;
+class UUserWidget;
+struct FInteractionOption;
+
+/** A single interaction option template, which interactables can refer to by its id instead of building the option themselves. */
+USTRUCT(BlueprintType)
+struct FInteractionOptionTemplate
+{
+	GENERATED_BODY()
+
+public:
+	/** Builds the interaction option described by this template */
+	void BuildOption(FInteractionOption& OutOption) const;
+
+public:
+	/** The id interactables use to refer to this template */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Interaction)
+	FGameplayTag TemplateId;
+
+	/** Simple text the interaction might return */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Interaction)
+	FText Text;
+
+	/** Simple subtext the interaction might return */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Interaction)
+	FText SubText;
+
+	/** The ability to grant the avatar when they get near interactable objects. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Interaction)
+	TSubclassOf<UGameplayAbility> InteractionAbilityToGrant;
+
+	/** Soft variant of the ability to grant, streamed in once the interactable is near a player. Not loaded together with the templates. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Interaction)
+	TSoftClassPtr<UGameplayAbility> SoftInteractionAbilityToGrant;
+
+	/** The widget to show for this kind of interaction. Loaded together with the templates. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Interaction)
+	TSoftClassPtr<UUserWidget> InteractionWidgetClass;
+
+	/** Generic tags describing this interaction. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Interaction)
+	FGameplayTagContainer InteractionTags;
+
+	/** Time the interaction has to be held to complete, 0 for instant interactions. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Interaction, meta = (ClampMin = 0, Units = "s"))
+	float HoldDuration = 0.f;
+
+	/** Tags the querying ability system has to own, or must not own, for this option to be offered. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Interaction)
+	FInteractionTagRequirements TagRequirements;
+};
+
+/**
+ * Data asset holding a set of interaction option templates.
+ * All assets of this type are loaded once by the UInteractionOptionTemplateSubsystem,
+ * make sure the "InteractionOptionTemplates" primary asset type is scanned by the asset manager.
+ */
+UCLASS(BlueprintType, Const)
+class INTERACTIONCORE_API UInteractionOptionTemplates : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UInteractionOptionTemplates();
+
+	/** The primary asset type of all interaction option template assets */
+	static const FPrimaryAssetType PrimaryAssetType;
+
+	//~ Begin UObject Interface
+	virtual FPrimaryAssetId GetPrimaryAssetId() const override;
+#if WITH_EDITOR
+	virtual EDataValidationResult IsDataValid(class FDataValidationContext& Context) const override;
+#endif
+	//~ End UObject Interface
+
+public:
+	/** List of all templates in this asset */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Interaction, meta = (TitleProperty = "TemplateId"))
+	TArray<FInteractionOptionTemplate> Templates;
+};
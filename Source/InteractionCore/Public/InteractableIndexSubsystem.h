@@ -0,0 +1,304 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InteractableIndexTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tasks/Task.h"
+
+#include "InteractableIndexSubsystem.generated.h"
+
+class AActor;
+class IInteractableTarget;
+class UInteractableIndexLevelData;
+class ULevel;
+class UObject;
+class USceneComponent;
+class UWorld;
+
+/**
+ * Called with the interactables that entered and left the radius of an interactable index observer.
+ * Interactables that left are passed by the key they entered with, as their target may be gone by now.
+ */
+DECLARE_DELEGATE_TwoParams(FInteractableProximityChangedDelegate, const TArray<FInteractableIndexEntry>& /*Entered*/, const TArray<FInteractableIndexEntryKey>& /*Exited*/);
+
+/**
+ * World subsystem keeping a spatial index of all interactables in the loaded levels.
+ *
+ * Interactables are registered per level (or World Partition cell, which is streamed as a level) when it becomes visible
+ * and dropped as a whole when it streams out. Gathering the interactables of a level is time-sliced on the game thread,
+ * building the spatial grid of a cell can optionally run on a worker thread.
+ */
+UCLASS()
+class INTERACTIONCORE_API UInteractableIndexSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UInteractableIndexSubsystem();
+	static UInteractableIndexSubsystem* Get(const UObject* WorldContextObject);
+
+	//~ Begin UWorldSubsystem Interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~ End UWorldSubsystem Interface
+
+	//~ Begin FTickableGameObject Interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~ End FTickableGameObject Interface
+
+	/** Registers an interactable that wasn't placed in a level, e.g. one that was spawned or changed at runtime. */
+	void RegisterInteractable(const TScriptInterface<IInteractableTarget>& Interactable);
+
+	/** Re-registers a single instance of an instanced interactable, e.g. after it was enabled or switched its option. */
+	void RegisterInteractableInstance(const TScriptInterface<IInteractableTarget>& Interactable, int32 InstanceIndex);
+
+	/** Unregisters an interactable from the index. */
+	void UnregisterInteractable(const TScriptInterface<IInteractableTarget>& Interactable);
+
+	/** Registers all interactables of the given actor. */
+	void RegisterActor(AActor* Actor);
+
+	/** Unregisters all interactables of the given actor. */
+	void UnregisterActor(AActor* Actor);
+
+	/** Calls the given function for all indexed interactables matching the filter whose bounds intersect the given sphere */
+	void ForEachInteractableInSphere(const FVector& Center, double Radius, const FInteractableCategoryFilter& CategoryFilter, TFunctionRef<void(const FInteractableIndexEntry&)> Func) const;
+
+	/** Returns all indexed interactables matching the filter whose bounds intersect the given sphere */
+	void QuerySphere(const FVector& Center, double Radius, TArray<FInteractableIndexEntry>& OutEntries, const FInteractableCategoryFilter& CategoryFilter = FInteractableCategoryFilter()) const;
+
+	/**
+	 * Finds the indexed interactables closest to the given location, sorted by distance.
+	 * The cost scales with the number of requested interactables rather than with everything in range.
+	 */
+	void FindNearestInteractables(const FVector& Location, double MaxDistance, int32 MaxCount, TArray<FInteractableIndexEntry>& OutEntries, const FInteractableCategoryFilter& CategoryFilter = FInteractableCategoryFilter()) const;
+
+	/**
+	 * Finds the closest indexed interactable whose bounds are hit by the given segment, without touching the physics scene.
+	 * Only the bounds of interactables are known to the index, so this doesn't account for anything blocking the segment.
+	 * Moving interactables are tested where they are now rather than where they were last sampled.
+	 */
+	bool RaycastInteractable(const FVector& Start, const FVector& End, const AActor* IgnoredActor, FInteractableIndexEntry& OutEntry, double& OutDistance, const FInteractableCategoryFilter& CategoryFilter = FInteractableCategoryFilter()) const;
+
+	/** Finds the entry of the given interactable if its bounds intersect the given sphere, returns false if it isn't indexed or out of range */
+	bool FindInteractable(const FInteractableIndexEntryKey& Key, const FVector& Center, double Radius, FInteractableIndexEntry& OutEntry) const;
+
+	/**
+	 * Returns the queryable cells whose bounds intersect the given sphere, so they can be queried from other threads with
+	 * FInteractableIndexCell::CopyEntriesInSphere. Cells stay alive as long as they are referenced, even once their level streamed out.
+	 */
+	void GetCellsInSphere(const FVector& Center, double Radius, TArray<TSharedPtr<const FInteractableIndexCell>>& OutCells) const;
+
+	/** Returns whether the interactables of the given level are indexed and queryable */
+	bool IsLevelIndexed(const ULevel* Level) const;
+
+	/** Returns the revision of the index, which changes whenever any interactable was added or removed */
+	uint32 GetIndexRevision() const { return IndexRevision; }
+
+	/**
+	 * Returns the transform a moving interactable had at the given time, interpolated from its recorded history.
+	 * Only interactables reporting IInteractableTarget::IsMovingInteractable have a history.
+	 *
+	 * @param Time Server world time, see AGameStateBase::GetServerWorldTimeSeconds.
+	 */
+	bool GetInteractableTransformAtTime(const UObject* Target, double Time, FTransform& OutTransform) const;
+
+	/**
+	 * Validates an interaction against where the target was at the given time, so interactions with moving targets are judged by
+	 * what the client saw instead of where the target is on the server now. Times older than MaxInteractionRewindTime are clamped.
+	 *
+	 * @param Instigator The avatar performing the interaction.
+	 * @param Target The interactable target object.
+	 * @param InstanceIndex The instance of the target, INDEX_NONE if the target isn't instanced.
+	 * @param Time Server world time the client interacted at, see AGameStateBase::GetServerWorldTimeSeconds.
+	 * @param MaxRange Maximum distance from the instigator to the bounds of the target.
+	 * @param bCheckLineOfSight Whether to trace from the eyes of the instigator to the rewound target.
+	 * @return False if the interaction should be rejected.
+	 */
+	bool ValidateInteraction(const AActor* Instigator, const UObject* Target, int32 InstanceIndex, double Time, float MaxRange, bool bCheckLineOfSight) const;
+
+	/**
+	 * Registers an observer that is notified whenever interactables matching the filter enter or leave its radius.
+	 * The observer has to be moved with UpdateObserver, which is also when the notifications are sent.
+	 *
+	 * @return Id of the new observer.
+	 */
+	int32 RegisterObserver(double Radius, FInteractableProximityChangedDelegate Delegate, const FInteractableCategoryFilter& CategoryFilter = FInteractableCategoryFilter());
+
+	/** Unregisters an observer, without notifying it about anything that is still inside its radius. */
+	void UnregisterObserver(int32 ObserverId);
+
+	/**
+	 * Moves an observer and notifies it about all interactables that entered or left its radius since its last update.
+	 * Only cells that changed since then are looked at, so this is nearly free while neither the observer nor anything around it changes.
+	 */
+	void UpdateObserver(int32 ObserverId, const FVector& Location);
+
+protected:
+	/** Called when a level became visible in any world */
+	void OnLevelAddedToWorld(ULevel* Level, UWorld* World);
+
+	/** Called when a level was hidden in any world */
+	void OnLevelRemovedFromWorld(ULevel* Level, UWorld* World);
+
+	/** Called when any actor was spawned in our world */
+	void OnActorSpawned(AActor* Actor);
+
+	/** Called when any actor was destroyed in our world */
+	void OnActorDestroyed(AActor* Actor);
+
+	/** Queues a level to have its interactables gathered */
+	void QueueLevel(ULevel* Level);
+
+	/** Gathers the interactables of pending levels, within the per-frame budget */
+	void ProcessPendingGathers();
+
+	/** Publishes all cells whose grid finished building */
+	void ProcessPendingBuilds();
+
+	/** Starts building the grid of a cell, or builds it inline if async builds are disabled */
+	void BuildCell(const TSharedRef<FInteractableIndexCell>& Cell);
+
+	/** Makes a built cell queryable */
+	void PublishCell(const TSharedRef<FInteractableIndexCell>& Cell);
+
+	/** Returns whether the interactables of the given level are still being gathered or built */
+	bool IsLevelPending(const ULevel* Level) const;
+
+	/** Gathers the index entries of all interactables of the given actor, and starts tracking the moving ones */
+	void GatherEntriesForActor(AActor* Actor, TArray<FInteractableIndexEntry>& OutEntries);
+
+	/**
+	 * Starts recording the transform history of a moving interactable
+	 *
+	 * @param Entries The index entries the interactable was just registered with.
+	 */
+	void TrackMovingInteractable(const TScriptInterface<IInteractableTarget>& Interactable, TConstArrayView<FInteractableIndexEntry> Entries);
+
+	/** Records the transforms of all moving interactables if a sample is due, and moves their index entries along with them */
+	void RecordMovingInteractables();
+
+	/** Returns the time the transform history is recorded in, the server world time if there is a game state */
+	double GetHistoryTime() const;
+
+private:
+	/** A level whose interactables are being gathered */
+	struct FPendingGather
+	{
+		TSharedPtr<FInteractableIndexCell> Cell;
+
+		/** The data baked for the level, only its runtime actors have to be gathered if set */
+		TWeakObjectPtr<const UInteractableIndexLevelData> BakedData;
+
+		/** Index of the next actor of the level to gather */
+		int32 NextActorIndex = 0;
+	};
+
+	/** What an observer knows about a single cell */
+	struct FObserverCellState
+	{
+		/** Revision of the cell when the observer last looked at it */
+		uint32 Revision = 0;
+
+		/** The entries of the cell inside the radius of the observer, by the key they entered with */
+		TMap<FInteractableIndexEntryKey, FInteractableIndexEntry> Inside;
+	};
+
+	/** An observer notified about interactables entering or leaving its radius */
+	struct FObserver
+	{
+		FInteractableProximityChangedDelegate Delegate;
+		FVector Location = FVector::ZeroVector;
+		double Radius = 0.0;
+		FInteractableCategoryFilter CategoryFilter;
+		bool bHasLocation = false;
+
+		/** Revision of the index when the observer was last updated */
+		uint32 IndexRevision = 0;
+
+		TMap<TObjectKey<ULevel>, FObserverCellState> CellStates;
+	};
+
+	/** A single recorded transform of a moving interactable */
+	struct FTransformSample
+	{
+		double Time = 0.0;
+		FTransform Transform;
+	};
+
+	/** A moving interactable and the ring buffer of its recorded transforms */
+	struct FMovingInteractable
+	{
+		TWeakObjectPtr<UObject> Target;
+
+		/** The component that moves the target, the target itself or the root of its actor */
+		TWeakObjectPtr<USceneComponent> Component;
+
+		/** The index entries of the target, as they were registered */
+		TArray<FInteractableIndexEntry> Entries;
+
+		/** Transform of the component when the entries were registered */
+		FTransform RegisteredTransform;
+
+		/** Transform of the component the entries in the index were last moved to, see RecordMovingInteractables */
+		FTransform IndexedTransform;
+
+		/** Locations the entries are currently indexed at, parallel to Entries */
+		TArray<FVector> IndexedLocations;
+
+		TArray<FTransformSample> Samples;
+
+		/** Index of the sample that is overwritten next */
+		int32 NextSampleIndex = 0;
+
+		/** Returns the sample with the given age, 0 being the latest */
+		const FTransformSample& GetSample(int32 Age) const
+		{
+			return Samples[(NextSampleIndex - 1 - Age + Samples.Num() * 2) % Samples.Num()];
+		}
+	};
+
+	/** A cell whose grid is being built on a worker thread */
+	struct FPendingBuild
+	{
+		TSharedPtr<FInteractableIndexCell> Cell;
+		UE::Tasks::FTask Task;
+	};
+
+	/** All queryable cells, by level */
+	TMap<TObjectKey<ULevel>, TSharedPtr<FInteractableIndexCell>> Cells;
+
+	/** Levels whose interactables are being gathered */
+	TArray<FPendingGather> PendingGathers;
+
+	/** Cells that are being built */
+	TArray<FPendingBuild> PendingBuilds;
+
+	/** Actors that were spawned while their level wasn't published yet */
+	TArray<TWeakObjectPtr<AActor>> DeferredActors;
+
+	/** All tracked moving interactables */
+	TArray<FMovingInteractable> MovingInteractables;
+
+	/** Time the last transform sample was recorded */
+	double LastHistorySampleTime = -UE_BIG_NUMBER;
+
+	/** All registered observers, by id */
+	TMap<int32, FObserver> Observers;
+
+	/** Id of the next registered observer */
+	int32 NextObserverId = 0;
+
+	/** Incremented whenever any cell was published, removed or changed */
+	uint32 IndexRevision = 0;
+
+	FDelegateHandle LevelAddedHandle;
+	FDelegateHandle LevelRemovedHandle;
+	FDelegateHandle ActorSpawnedHandle;
+	FDelegateHandle ActorDestroyedHandle;
+};
@@ -0,0 +1,206 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "UObject/ObjectKey.h"
+#include "UObject/WeakObjectPtr.h"
+
+class IInteractableTarget;
+class ULevel;
+
+/** Identifies a single interactable (or a single instance of an instanced interactable) in the interactable index. */
+struct FInteractableIndexEntryKey
+{
+	FInteractableIndexEntryKey() = default;
+	FInteractableIndexEntryKey(const UObject* InTarget, int32 InInstanceIndex)
+		: Target(InTarget)
+		, InstanceIndex(InInstanceIndex)
+	{
+	}
+
+	FObjectKey Target;
+	int32 InstanceIndex = INDEX_NONE;
+
+	bool operator==(const FInteractableIndexEntryKey& Other) const
+	{
+		return Target == Other.Target && InstanceIndex == Other.InstanceIndex;
+	}
+
+	friend uint32 GetTypeHash(const FInteractableIndexEntryKey& Key)
+	{
+		return HashCombine(GetTypeHash(Key.Target), GetTypeHash(Key.InstanceIndex));
+	}
+};
+
+/**
+ * Filters interactable index entries by their category mask, see UInteractionCoreSettings::InteractableCategories.
+ * Rejecting an entry only takes a couple of ANDs, so filters are applied before any other test.
+ */
+struct FInteractableCategoryFilter
+{
+	/** Entries need at least one of these categories, 0 accepts entries of any category */
+	uint64 IncludeMask = 0;
+
+	/** Entries must not have any of these categories */
+	uint64 ExcludeMask = 0;
+
+	/** Set if categories were asked for but none of them is configured, so no entry can match */
+	bool bRejectAll = false;
+
+	bool Matches(uint64 CategoryMask) const
+	{
+		return !bRejectAll && (CategoryMask & ExcludeMask) == 0 && (IncludeMask == 0 || (CategoryMask & IncludeMask) != 0);
+	}
+
+	/** Returns whether every entry matches */
+	bool IsEmpty() const
+	{
+		return IncludeMask == 0 && ExcludeMask == 0 && !bRejectAll;
+	}
+};
+
+/** A single interactable (or a single instance of an instanced interactable) in the interactable index. */
+struct FInteractableIndexEntry
+{
+	/** The interactable target object */
+	TWeakObjectPtr<UObject> Target;
+
+	/** The instance of the target, INDEX_NONE if the target isn't instanced */
+	int32 InstanceIndex = INDEX_NONE;
+
+	/** World location of the interactable */
+	FVector Location = FVector::ZeroVector;
+
+	/** World bounds of the interactable */
+	FBox Bounds = FBox(ForceInit);
+
+	/** Bitmask of the categories of the interactable, zero if it isn't categorized */
+	uint64 CategoryMask = 0;
+
+	/** The option template the interactable provides, if it provides a single templated option */
+	FGameplayTag OptionTemplateId;
+
+	/** Returns the interactable target interface, nullptr if the target is gone */
+	TScriptInterface<IInteractableTarget> GetInteractableTarget() const;
+
+	/** Returns the key identifying this entry */
+	FInteractableIndexEntryKey GetKey() const
+	{
+		return FInteractableIndexEntryKey(Target.Get(), InstanceIndex);
+	}
+};
+
+namespace InteractableIndex
+{
+	/**
+	 * Slab test of a ray against a box, computing all three axes at once.
+	 *
+	 * @param Origin Origin of the ray.
+	 * @param InvDirection Component wise inverse of the (normalized) ray direction.
+	 * @param MaxDistance Length of the ray.
+	 * @param OutDistance Receives the distance from the origin to where the box is entered, 0 if the origin is inside the box.
+	 */
+	INTERACTIONCORE_API bool IntersectRayBox(const FVector& Origin, const FVector& InvDirection, double MaxDistance, const FBox& Box, double& OutDistance);
+
+	/** Returns the component wise inverse of the given (normalized) ray direction, axis parallel rays get a huge but finite inverse */
+	INTERACTIONCORE_API FVector MakeInvRayDirection(const FVector& Direction);
+}
+
+/**
+ * All interactables of a single level or World Partition cell, with a uniform grid on top.
+ * Cells are built once when their level streams in and dropped as a whole when it streams out.
+ */
+struct FInteractableIndexCell
+{
+	/** The level this cell was built for */
+	TWeakObjectPtr<ULevel> Level;
+
+	/** All entries of this cell */
+	TArray<FInteractableIndexEntry> Entries;
+
+	/** Entry indices by grid coordinate, entries are bucketed by their location */
+	TMap<FIntVector, TArray<int32>> Grid;
+
+	/** Bounds of all entries */
+	FBox Bounds = FBox(ForceInit);
+
+	/** Largest half extent of any entry, used to pad queries since entries are bucketed by location only */
+	double MaxEntryExtent = 0.0;
+
+	/** Size of a single grid cell */
+	double GridCellSize = 1000.0;
+
+	/** Number of removed entries that are still kept as tombstones */
+	int32 NumRemovedEntries = 0;
+
+	/** Incremented whenever entries are added or removed, so observers can skip cells that didn't change */
+	uint32 Revision = 0;
+
+	/**
+	 * Guards the entries and the grid against readers on other threads.
+	 * Only the game thread changes published cells, so it takes the write lock for changes but reads without locking.
+	 */
+	mutable FRWLock Lock;
+
+	/** (Re-)builds the grid from the entries. Doesn't touch any UObject, so it is safe to call from worker threads. */
+	void BuildGrid(double InGridCellSize);
+
+	/** Adds a single entry to an already built cell */
+	void AddEntry(const FInteractableIndexEntry& Entry);
+
+	/** Removes all entries of the given target, returns the number of removed entries */
+	int32 RemoveEntriesForTarget(const UObject* Target);
+
+	/** Removes the entry with the given key, returns whether it was found */
+	bool RemoveEntry(const FInteractableIndexEntryKey& Key);
+
+	/**
+	 * Moves the entry with the given key to a new location and bounds, moving it to the grid cell of its new location.
+	 *
+	 * @param OldLocation The location the entry is currently indexed at, used to find its grid cell.
+	 * @return Whether the entry was found.
+	 */
+	bool MoveEntry(const FInteractableIndexEntryKey& Key, const FVector& OldLocation, const FVector& NewLocation, const FBox& NewBounds);
+
+	/** Copies all entries matching the filter whose bounds intersect the given sphere. Takes the read lock, so it is safe to call from any thread. */
+	void CopyEntriesInSphere(const FVector& Center, double Radius, const FInteractableCategoryFilter& CategoryFilter, TArray<FInteractableIndexEntry>& OutEntries) const;
+
+	/** Calls the given function for all entries matching the filter whose bounds intersect the given sphere */
+	void ForEachEntryInSphere(const FVector& Center, double Radius, const FInteractableCategoryFilter& CategoryFilter, TFunctionRef<void(const FInteractableIndexEntry&)> Func) const;
+
+	/**
+	 * Finds the closest entry whose bounds are hit by the given segment. Entries without bounds can't be hit.
+	 * Walks the grid cell by cell along the segment and stops once no closer entry can be found.
+	 * Skips entries whose target is gone, so unlike building the grid this has to run on the game thread.
+	 *
+	 * @param CategoryFilter Only entries matching the filter can be hit.
+	 * @param Predicate Returns whether an entry can be hit, only called for entries whose bounds are hit.
+	 * @param OutDistance Receives the distance from the start to where the bounds of the entry are entered.
+	 * @return The closest hit entry, nullptr if none was hit.
+	 */
+	const FInteractableIndexEntry* RaycastEntries(const FVector& Start, const FVector& End, const FInteractableCategoryFilter& CategoryFilter, TFunctionRef<bool(const FInteractableIndexEntry&)> Predicate, double& OutDistance) const;
+
+	/**
+	 * Adds the entries closest to the given center to a bounded max heap shared across cells.
+	 * Expands ring by ring through the grid and stops as soon as no closer entry can be found, so the cost scales with the number
+	 * of requested entries rather than with everything in range.
+	 *
+	 * @param MaxCount Maximum number of entries in the heap.
+	 * @param InOutHeap Heap of (squared distance, entry) pairs, ordered with the farthest entry on top.
+	 */
+	void FindNearestEntries(const FVector& Center, double MaxDistance, int32 MaxCount, const FInteractableCategoryFilter& CategoryFilter, TArray<TPair<double, const FInteractableIndexEntry*>>& InOutHeap) const;
+
+	/** Removes all entries the predicate returns true for, keeping them as tombstones until enough of them piled up */
+	int32 RemoveEntriesMatching(TFunctionRef<bool(const FInteractableIndexEntry&)> Predicate);
+
+	/** Returns the grid coordinate of the given location */
+	FIntVector GetGridCoord(const FVector& Location) const
+	{
+		return FIntVector(
+			FMath::FloorToInt32(Location.X / GridCellSize),
+			FMath::FloorToInt32(Location.Y / GridCellSize),
+			FMath::FloorToInt32(Location.Z / GridCellSize));
+	}
+};
@@ -0,0 +1,61 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Templates/SubclassOf.h"
+
+#include "InteractionAbilityStreamingSubsystem.generated.h"
+
+class UGameplayAbility;
+class UObject;
+struct FStreamableHandle;
+
+/** Called when a soft-referenced interaction ability finished streaming in. */
+DECLARE_MULTICAST_DELEGATE_OneParam(FInteractionAbilityStreamedDelegate, const TSoftClassPtr<UGameplayAbility>& /*AbilityClass*/);
+
+/**
+ * World subsystem streaming in soft-referenced interaction abilities, see FInteractionOption::SoftInteractionAbilityToGrant.
+ * Shared by all players of the world, so an ability class is only requested once no matter how many players come near its interactables.
+ * Streamed in classes are kept loaded for the lifetime of the world.
+ */
+UCLASS()
+class INTERACTIONCORE_API UInteractionAbilityStreamingSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UInteractionAbilityStreamingSubsystem();
+	static UInteractionAbilityStreamingSubsystem* Get(const UObject* WorldContextObject);
+
+	//~ Begin UWorldSubsystem Interface
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~ End UWorldSubsystem Interface
+
+	/**
+	 * Starts streaming in the given ability class, unless it is loaded or already streaming in.
+	 *
+	 * @return The ability class if it is loaded, nullptr if it has to be waited for, see OnAbilityClassStreamed.
+	 */
+	TSubclassOf<UGameplayAbility> RequestAbilityClass(const TSoftClassPtr<UGameplayAbility>& AbilityClass);
+
+	/** Returns whether the given ability class is still streaming in */
+	bool IsStreamingAbilityClass(const TSoftClassPtr<UGameplayAbility>& AbilityClass) const;
+
+	/** Called whenever a requested ability class finished streaming in */
+	FInteractionAbilityStreamedDelegate OnAbilityClassStreamed;
+
+protected:
+	/** Called when a requested ability class finished streaming in */
+	void HandleAbilityClassStreamed(TSoftClassPtr<UGameplayAbility> AbilityClass);
+
+private:
+	/** Ability classes that finished streaming in, kept alive for the lifetime of the subsystem */
+	UPROPERTY(Transient)
+	TArray<TSubclassOf<UGameplayAbility>> StreamedAbilityClasses;
+
+	/** Pending async loads, by ability class */
+	TMap<FSoftObjectPath, TSharedPtr<FStreamableHandle>> PendingLoads;
+};
@@ -0,0 +1,88 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include <atomic>
+
+#include "InteractionClaimSubsystem.generated.h"
+
+class UObject;
+
+/**
+ * World subsystem keeping track of which interactables are claimed by whom, so contested targets (containers, NPCs, ...)
+ * can be rejected before an interaction ability is activated instead of resolving the conflict late.
+ *
+ * Claims live in a fixed size open addressing table of atomic slots. Claims are only made and released on the game thread,
+ * but whether a target is claimed can be looked up lock-free from any thread. Claims expire, so a claimant that never
+ * releases its claim doesn't block the target forever.
+ *
+ * Claims are authority-only. The table is per world and not replicated, so remote clients never see claims made on the
+ * server and IsClaimedByOther always returns false there; claimed targets are only filtered out of the options gathered
+ * on the server. Claimants are compared by identity with the ability system component of the querying avatar
+ * (see FInteractionQueryRequest and UAbilityTask_WaitForInteractableTargets), so claim with that component.
+ */
+UCLASS()
+class INTERACTIONCORE_API UInteractionClaimSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UInteractionClaimSubsystem();
+	static UInteractionClaimSubsystem* Get(const UObject* WorldContextObject);
+
+	//~ Begin UWorldSubsystem Interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~ End UWorldSubsystem Interface
+
+	/**
+	 * Claims the given interactable, or refreshes the claim if the claimant already holds it.
+	 *
+	 * @param Target The interactable target object.
+	 * @param InstanceIndex The instance of the target, INDEX_NONE if the target isn't instanced.
+	 * @param Claimant The ability system component of the interacting avatar, claims by any other object are never matched by option gathering.
+	 * @param Duration Time until the claim expires, the default claim duration if negative.
+	 * @return True if the claimant holds the claim, false if someone else holds it or the table is full.
+	 */
+	bool TryClaim(const UObject* Target, int32 InstanceIndex, const UObject* Claimant, float Duration = -1.f);
+
+	/** Releases the claim of the given claimant on the given interactable, if it holds it */
+	void Release(const UObject* Target, int32 InstanceIndex, const UObject* Claimant);
+
+	/** Returns whether anyone but the given claimant holds a claim on the given interactable. Lock-free, safe to call from any thread. */
+	bool IsClaimedByOther(const UObject* Target, int32 InstanceIndex, const UObject* Claimant) const;
+
+	/** Returns the number of slots holding a claim, including expired claims that weren't replaced yet */
+	int32 GetNumClaims() const { return NumClaims.load(std::memory_order_relaxed); }
+
+private:
+	/** A single slot of the claim table */
+	struct FClaimSlot
+	{
+		/** Key of the claimed interactable, 0 if the slot was never used */
+		std::atomic<uint64> Key{0};
+
+		/** Id of the claimant in the upper, expire time in the lower 32 bits. 0 if the slot isn't claimed. */
+		std::atomic<uint64> ClaimWord{0};
+	};
+
+	/** Finds the slot of the given key, nullptr if there is none */
+	const FClaimSlot* FindSlot(uint64 Key) const;
+
+	/** Returns the current world time in claim time units */
+	uint32 GetClaimTime() const;
+
+private:
+	/** The claim table, its size is a power of two */
+	TUniquePtr<FClaimSlot[]> Slots;
+
+	/** Size of the claim table minus one */
+	uint32 SlotMask = 0;
+
+	/** Number of slots with a non-zero claim word */
+	std::atomic<int32> NumClaims{0};
+};
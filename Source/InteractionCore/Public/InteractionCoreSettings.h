@@ -0,0 +1,258 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "Engine/DeveloperSettings.h"
+#include "GameplayTagContainer.h"
+#include "InteractionFrameBudget.h"
+
+#include "InteractionCoreSettings.generated.h"
+
+class UObject;
+struct FInteractableCategoryFilter;
+
+/** Project wide settings for the interaction core plugin. */
+UCLASS(Config = Game, DefaultConfig, meta = (DisplayName = "Interaction Core"))
+class INTERACTIONCORE_API UInteractionCoreSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	UInteractionCoreSettings();
+
+	/** Returns the interaction core settings */
+	static const UInteractionCoreSettings* Get() { return GetDefault<UInteractionCoreSettings>(); }
+
+	//~ Begin UDeveloperSettings Interface
+	virtual FName GetCategoryName() const override { return TEXT("Plugins"); }
+	//~ End UDeveloperSettings Interface
+
+	//~ Begin UObject Interface
+#if WITH_EDITOR
+	virtual EDataValidationResult IsDataValid(class FDataValidationContext& Context) const override;
+#endif
+	//~ End UObject Interface
+
+	/** Returns the category mask of the given tags, with a bit set for every interactable category any of the tags matches */
+	uint64 MakeCategoryMask(const FGameplayTagContainer& Tags) const;
+
+	/**
+	 * Returns a category filter accepting entries with any of the included and none of the excluded categories.
+	 * A tag stands for the categories that are the tag itself or one of its children, so a filter never gets broader than asked.
+	 * Tags standing for no category are ignored with a warning, if none of the include tags stands for a category everything is rejected.
+	 */
+	FInteractableCategoryFilter MakeCategoryFilter(const FGameplayTagContainer& IncludeTags, const FGameplayTagContainer& ExcludeTags) const;
+
+public:
+	//-------------------------------------------------------------------------
+	// Scan Significance
+	//-------------------------------------------------------------------------
+
+	/** Significance added for scanners owned by a locally controlled avatar. */
+	UPROPERTY(Config, EditAnywhere, Category = "Scan Significance", meta = (ClampMin = 0))
+	float LocalPlayerSignificance = 0.5f;
+
+	/** Significance added while the scanner is currently showing an interaction prompt. */
+	UPROPERTY(Config, EditAnywhere, Category = "Scan Significance", meta = (ClampMin = 0))
+	float PromptShownSignificance = 0.3f;
+
+	/** Significance added for a nearby interactable, fading out linearly until ProximitySignificanceRange. */
+	UPROPERTY(Config, EditAnywhere, Category = "Scan Significance", meta = (ClampMin = 0))
+	float ProximitySignificance = 0.2f;
+
+	/** Distance at which a nearby interactable no longer adds any significance. */
+	UPROPERTY(Config, EditAnywhere, Category = "Scan Significance", meta = (ClampMin = 0, Units = "cm"))
+	float ProximitySignificanceRange = 1000.f;
+
+	/** Significance removed while the avatar is in combat, as players rarely interact with objects during combat. */
+	UPROPERTY(Config, EditAnywhere, Category = "Scan Significance", meta = (ClampMin = 0))
+	float InCombatSignificancePenalty = 0.3f;
+
+	/** The tag on the avatar's ability system that marks it as in combat. */
+	UPROPERTY(Config, EditAnywhere, Category = "Scan Significance")
+	FGameplayTag InCombatTag;
+
+	/** Scanners with at least this significance scan at their baseline scan rate. */
+	UPROPERTY(Config, EditAnywhere, Category = "Scan Significance", meta = (ClampMin = 0))
+	float HighSignificanceThreshold = 0.5f;
+
+	/** Scanners with at least this significance (but below high) scan at the medium scan rate scale. */
+	UPROPERTY(Config, EditAnywhere, Category = "Scan Significance", meta = (ClampMin = 0))
+	float MediumSignificanceThreshold = 0.2f;
+
+	/** Multiplier applied to the baseline scan interval of medium significance scanners. */
+	UPROPERTY(Config, EditAnywhere, Category = "Scan Significance", meta = (ClampMin = 1))
+	float MediumSignificanceIntervalScale = 2.f;
+
+	/** Multiplier applied to the baseline scan interval of low significance scanners. */
+	UPROPERTY(Config, EditAnywhere, Category = "Scan Significance", meta = (ClampMin = 1))
+	float LowSignificanceIntervalScale = 5.f;
+
+	/** Maximum number of scans performed per frame, the most significant scanners go first. 0 means unlimited. */
+	UPROPERTY(Config, EditAnywhere, Category = "Scan Significance", meta = (ClampMin = 0))
+	int32 MaxScansPerFrame = 0;
+
+	/** Significance a deferred scanner gains per second it is overdue, so low significance scanners can't starve. */
+	UPROPERTY(Config, EditAnywhere, Category = "Scan Significance", meta = (ClampMin = 0))
+	float OverdueSignificancePerSecond = 1.f;
+
+	//-------------------------------------------------------------------------
+	// Frame Budgets
+	//-------------------------------------------------------------------------
+
+	/**
+	 * Per-frame time budgets shared by the interaction and indicator modules, by scalability level (Low, Medium, High, Epic, Cinematic).
+	 * The lowest quality level of all scalability groups picks the budgets, levels past the last entry use the last one. No entries means unlimited.
+	 * Budgets can be overridden per platform in the Game.ini of the platform.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Frame Budgets")
+	TArray<FInteractionFrameBudgets> FrameBudgetsByScalability;
+
+	/** Priority deferred work gains per frame it was deferred, so work that keeps missing the budget can't starve. */
+	UPROPERTY(Config, EditAnywhere, Category = "Frame Budgets", meta = (ClampMin = 0))
+	float DeferredWorkPriorityPerFrame = 1.f;
+
+	//-------------------------------------------------------------------------
+	// Focus Hysteresis
+	//-------------------------------------------------------------------------
+
+	/** Number of recent scans line trace scanners remember to decide whether to switch focus to another interactable. */
+	UPROPERTY(Config, EditAnywhere, Category = "Focus Hysteresis", meta = (ClampMin = 1, ClampMax = 32))
+	int32 FocusHistorySize = 6;
+
+	/**
+	 * Time a new interactable has to be hit without interruption before focus switches to it. 0 disables the dwell time.
+	 * Only applies when switching between interactables, focus is released as soon as no interactable is hit.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Focus Hysteresis", meta = (ClampMin = 0, Units = "s"))
+	float FocusSwitchDwellTime = 0.f;
+
+	/**
+	 * Share of the recent scans a new interactable has to be hit in more often than the focused one before focus switches to it.
+	 * 0 disables the margin. If both the dwell time and the margin are disabled, focus switches immediately.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Focus Hysteresis", meta = (ClampMin = 0, ClampMax = 1))
+	float FocusSwitchScoreMargin = 0.f;
+
+	//-------------------------------------------------------------------------
+	// Highlighting
+	//-------------------------------------------------------------------------
+
+	/** Whether interaction tasks of locally controlled avatars outline their focused interactables, see UInteractionHighlightSubsystem. */
+	UPROPERTY(Config, EditAnywhere, Category = "Highlighting")
+	bool bHighlightFocusedInteractables = false;
+
+	/** Custom depth stencil value written by highlighted primitives, for the outline post process material to pick up. */
+	UPROPERTY(Config, EditAnywhere, Category = "Highlighting", meta = (ClampMin = 0, ClampMax = 255))
+	int32 HighlightStencilValue = 1;
+
+	//-------------------------------------------------------------------------
+	// Option Broadcasts
+	//-------------------------------------------------------------------------
+
+	/** Time changes of the interaction options are collected for before they are broadcast. 0 (the default) broadcasts every change immediately. */
+	UPROPERTY(Config, EditAnywhere, Category = "Option Broadcasts", meta = (ClampMin = 0, Units = "s"))
+	float InteractableOptionsCoalesceWindow = 0.f;
+
+	/** Maximum number of interaction option broadcasts per task and second. The latest options are always broadcast eventually. 0 (the default) means unlimited. */
+	UPROPERTY(Config, EditAnywhere, Category = "Option Broadcasts", meta = (ClampMin = 0))
+	float MaxInteractableOptionsBroadcastsPerSecond = 0.f;
+
+	//-------------------------------------------------------------------------
+	// Interaction Claims
+	//-------------------------------------------------------------------------
+
+	/** Maximum number of interactables that can be claimed at the same time per world, see UInteractionClaimSubsystem. */
+	UPROPERTY(Config, EditAnywhere, Category = "Interaction Claims", meta = (ClampMin = 1))
+	int32 MaxInteractionClaims = 1024;
+
+	/** Time until a claim on an interactable expires, unless the claimant refreshes or releases it before. */
+	UPROPERTY(Config, EditAnywhere, Category = "Interaction Claims", meta = (ClampMin = 0, Units = "s"))
+	float InteractionClaimDuration = 5.f;
+
+	//-------------------------------------------------------------------------
+	// Prompt Widgets
+	//-------------------------------------------------------------------------
+
+	/** Number of prompt widgets created up front for every prompt widget class once it is loaded. */
+	UPROPERTY(Config, EditAnywhere, Category = "Prompt Widgets", meta = (ClampMin = 0))
+	int32 PrewarmedPromptWidgetsPerClass = 1;
+
+	//-------------------------------------------------------------------------
+	// Interactable Index
+	//-------------------------------------------------------------------------
+
+	/** Size of a single grid cell of the interactable index. */
+	UPROPERTY(Config, EditAnywhere, Category = "Interactable Index", meta = (ClampMin = 1, Units = "cm"))
+	float InteractableIndexGridCellSize = 1000.f;
+
+	/** Maximum number of actors of streamed in levels that are checked for interactables per frame. */
+	UPROPERTY(Config, EditAnywhere, Category = "Interactable Index", meta = (ClampMin = 1))
+	int32 MaxInteractableActorsGatheredPerFrame = 256;
+
+	/** Whether the spatial grid of streamed in levels is built on a worker thread. */
+	UPROPERTY(Config, EditAnywhere, Category = "Interactable Index")
+	bool bBuildInteractableIndexCellsAsync = true;
+
+	/** Whether the cooker bakes the static interactables of every level, so cooked builds don't have to gather them at runtime. */
+	UPROPERTY(Config, EditAnywhere, Category = "Interactable Index")
+	bool bBakeInteractableIndexOnCook = true;
+
+	/** Distance an interactable index observer has to move before interactables entering or leaving its radius are recomputed. */
+	UPROPERTY(Config, EditAnywhere, Category = "Interactable Index", meta = (ClampMin = 0, Units = "cm"))
+	float InteractableObserverMoveTolerance = 25.f;
+
+	/** Time between two recorded transforms of moving interactables, see IInteractableTarget::IsMovingInteractable. */
+	UPROPERTY(Config, EditAnywhere, Category = "Interactable Index", meta = (ClampMin = 0, Units = "s"))
+	float InteractableHistorySampleInterval = 0.033f;
+
+	/** Number of transforms recorded per moving interactable, together with the sample interval this is how far back interactions can be rewound. */
+	UPROPERTY(Config, EditAnywhere, Category = "Interactable Index", meta = (ClampMin = 2, ClampMax = 256))
+	int32 InteractableHistorySize = 32;
+
+	/** How far back in time the server rewinds moving interactables when validating an interaction. */
+	UPROPERTY(Config, EditAnywhere, Category = "Interactable Index", meta = (ClampMin = 0, Units = "s"))
+	float MaxInteractionRewindTime = 0.5f;
+
+	/**
+	 * Number of nearest interactables the grant nearby interaction task gathers options from, the rest of the interactables in range is ignored.
+	 * Interactables past the limit get no ability granted, so they show no prompt until they are among the nearest.
+	 * Zero gathers the options of all interactables in range.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Interactable Index", meta = (ClampMin = 0))
+	int32 MaxNearbyInteractablesGathered = 0;
+
+	/**
+	 * Time the grant nearby interaction task looks ahead along the avatar's velocity, to grant the abilities of interactables it is
+	 * moving towards before they are in range. 0 disables predictive grants.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Interactable Index", meta = (ClampMin = 0, Units = "s"))
+	float InteractionGrantPredictionTime = 1.f;
+
+	/** Number of interactables ahead of the avatar the grant nearby interaction task gathers options from. */
+	UPROPERTY(Config, EditAnywhere, Category = "Interactable Index", meta = (ClampMin = 0))
+	int32 MaxPredictedInteractablesGathered = 4;
+
+	/** Maximum number of interaction abilities each grant nearby interaction task grants per frame, the rest waits for the next frames. 0 means unlimited. */
+	UPROPERTY(Config, EditAnywhere, Category = "Interactable Index", meta = (ClampMin = 0))
+	int32 MaxInteractionAbilityGrantsPerFrame = 2;
+
+	/**
+	 * Radius around the avatar of the grant nearby interaction task in which soft-referenced interaction abilities are streamed in,
+	 * see FInteractionOption::SoftInteractionAbilityToGrant. 0 only streams them in once their interactable is in range.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Interactable Index", meta = (ClampMin = 0, Units = "cm"))
+	float InteractionAbilityPrefetchRadius = 3000.f;
+
+	/** Number of nearest interactables within the prefetch radius whose soft-referenced interaction abilities are streamed in. */
+	UPROPERTY(Config, EditAnywhere, Category = "Interactable Index", meta = (ClampMin = 0))
+	int32 MaxPrefetchedInteractables = 16;
+
+	/**
+	 * Categories interactables are sorted into, e.g. loot, doors, NPCs or vehicles. Each category gets one bit of the
+	 * category mask stored in the interactable index, in order, so there can be at most 64 of them.
+	 * Child tags of a category are part of that category.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Interactable Index")
+	TArray<FGameplayTag> InteractableCategories;
+};
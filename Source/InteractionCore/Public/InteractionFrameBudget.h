@@ -0,0 +1,138 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "InteractionFrameBudget.generated.h"
+
+class FInteractionBudgetScope;
+
+/** The kinds of work sharing the interaction frame budget */
+UENUM()
+enum class EInteractionBudgetCategory : uint8
+{
+	/** Interaction scans run by the scan subsystem */
+	Scans,
+
+	/** Interaction abilities granted for nearby interactables */
+	Grants,
+
+	/** Projecting indicators onto the screen */
+	IndicatorProjection,
+
+	/** Creating indicator widgets */
+	IndicatorWidgets,
+
+	MAX UMETA(Hidden)
+};
+
+/** Per-frame time budgets of a single scalability level. 0 means unlimited. */
+USTRUCT()
+struct INTERACTIONCORE_API FInteractionFrameBudgets
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category = "Frame Budgets", meta = (ClampMin = 0, Units = "Microseconds"))
+	int32 Scans = 0;
+
+	UPROPERTY(EditAnywhere, Category = "Frame Budgets", meta = (ClampMin = 0, Units = "Microseconds"))
+	int32 Grants = 0;
+
+	UPROPERTY(EditAnywhere, Category = "Frame Budgets", meta = (ClampMin = 0, Units = "Microseconds"))
+	int32 IndicatorProjection = 0;
+
+	UPROPERTY(EditAnywhere, Category = "Frame Budgets", meta = (ClampMin = 0, Units = "Microseconds"))
+	int32 IndicatorWidgets = 0;
+
+	/** Returns the budget of the given category */
+	int32 GetBudget(EInteractionBudgetCategory Category) const;
+};
+
+/**
+ * Frame budget shared by everything in the interaction and indicator modules, so their worst cases can't all land on the same frame.
+ *
+ * Every category gets a per-frame time budget, picked from UInteractionCoreSettings::FrameBudgetsByScalability by the current
+ * scalability level. Work checks HasBudget before it starts and defers itself to a later frame if the budget is spent, the first
+ * piece of work of each category and frame always runs so nothing stalls. Overruns and deferred work are reported through stats,
+ * deferred work per category as well.
+ *
+ * Game thread only. Budgets are reset lazily with the first use in a new frame.
+ */
+class INTERACTIONCORE_API FInteractionFrameBudget
+{
+public:
+	/** Returns the budget shared by all worlds */
+	static FInteractionFrameBudget& Get();
+
+	/** Returns whether work of the given category may still start this frame */
+	bool HasBudget(EInteractionBudgetCategory Category);
+
+	/** Adds time spent on work of the given category this frame */
+	void ConsumeBudget(EInteractionBudgetCategory Category, double Microseconds);
+
+	/** Reports work of the given category that was deferred to a later frame */
+	void ReportDeferred(EInteractionBudgetCategory Category, int32 NumDeferred = 1);
+
+	/** Returns the number of pieces of work of the given category that were deferred this frame */
+	int32 GetNumDeferred(EInteractionBudgetCategory Category);
+
+	/** Returns the budget of the given category in microseconds, 0 if it is unlimited */
+	double GetBudget(EInteractionBudgetCategory Category);
+
+	/** Returns the time spent on work of the given category this frame in microseconds */
+	double GetUsedBudget(EInteractionBudgetCategory Category);
+
+	/** Returns the priority of work that was deferred for the given number of frames, so deferred work can't starve */
+	static float GetAgedPriority(float Priority, int32 FramesDeferred);
+
+private:
+	/** What a single category spent this frame */
+	struct FCategoryState
+	{
+		double Budget = 0.0;
+		double Used = 0.0;
+		int32 NumStarted = 0;
+		int32 NumDeferred = 0;
+		bool bOverrun = false;
+	};
+
+	/** Resets all categories if a new frame started */
+	void BeginFrameIfNeeded();
+
+	FCategoryState& GetState(EInteractionBudgetCategory Category);
+
+private:
+	friend class FInteractionBudgetScope;
+
+	/** The innermost open budget scope */
+	FInteractionBudgetScope* ActiveScope = nullptr;
+
+	FCategoryState States[static_cast<int32>(EInteractionBudgetCategory::MAX)];
+
+	/** The frame the states belong to */
+	uint64 FrameNumber = MAX_uint64;
+};
+
+/**
+ * Measures the time spent in its scope and consumes it from the budget of the given category.
+ * Scopes can be nested, time spent in an inner scope is only consumed from the budget of the inner one.
+ */
+class INTERACTIONCORE_API FInteractionBudgetScope
+{
+public:
+	explicit FInteractionBudgetScope(EInteractionBudgetCategory InCategory);
+	~FInteractionBudgetScope();
+
+	UE_NONCOPYABLE(FInteractionBudgetScope);
+
+private:
+	EInteractionBudgetCategory Category;
+	uint64 StartCycles = 0;
+
+	/** Cycles spent in inner scopes */
+	uint64 InnerCycles = 0;
+
+	/** The scope this one is nested in */
+	FInteractionBudgetScope* OuterScope = nullptr;
+};
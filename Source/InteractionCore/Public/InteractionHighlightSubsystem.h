@@ -0,0 +1,101 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "InteractionHighlightSubsystem.generated.h"
+
+class UObject;
+class UPrimitiveComponent;
+struct FInteractionOption;
+
+/**
+ * World subsystem outlining focused interactables by enabling custom depth and a stencil value on their primitives.
+ *
+ * Every focus owner (usually an interaction task) hands in its focused interactables whenever they change, the highlighted
+ * primitives are only updated once per frame and only for the difference between the previously and newly highlighted ones.
+ * Focus that flickers back and forth within a frame, or interactables that stay focused, never touch the render state.
+ * Primitives get their previous custom depth settings back once they aren't highlighted anymore.
+ *
+ * Instances of instanced interactables can't be highlighted on their own, so they are skipped.
+ */
+UCLASS()
+class INTERACTIONCORE_API UInteractionHighlightSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UInteractionHighlightSubsystem();
+	static UInteractionHighlightSubsystem* Get(const UObject* WorldContextObject);
+
+	//~ Begin UWorldSubsystem Interface
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~ End UWorldSubsystem Interface
+
+	//~ Begin FTickableGameObject Interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~ End FTickableGameObject Interface
+
+	/** Replaces the interactables focused by the given owner, applied with the next update */
+	UFUNCTION(BlueprintCallable, Category = Interaction)
+	void SetFocusedInteractables(const UObject* FocusOwner, const TArray<UObject*>& Interactables);
+
+	/** Replaces the interactables focused by the given owner with the targets of the given options, applied with the next update */
+	void SetFocusedInteractionOptions(const UObject* FocusOwner, const TArray<FInteractionOption>& Options);
+
+	/** Removes everything focused by the given owner, applied with the next update */
+	UFUNCTION(BlueprintCallable, Category = Interaction)
+	void ClearFocusedInteractables(const UObject* FocusOwner);
+
+	/** Applies pending focus changes right away instead of waiting for the next update */
+	UFUNCTION(BlueprintCallable, Category = Interaction)
+	void FlushHighlights();
+
+	/** Returns whether the given primitive is currently highlighted */
+	UFUNCTION(BlueprintPure, Category = Interaction)
+	bool IsHighlighted(const UPrimitiveComponent* Primitive) const;
+
+	/** Returns the number of primitives whose render state was changed since the subsystem was created */
+	int32 GetNumRenderStateChanges() const { return NumRenderStateChanges; }
+
+private:
+	/** Custom depth settings of a primitive before it was highlighted */
+	struct FSavedRenderState
+	{
+		bool bRenderCustomDepth = false;
+		int32 CustomDepthStencilValue = 0;
+	};
+
+	/**
+	 * Drops focus owners and interactables that went away, so their highlights are updated even if nobody changes the focus.
+	 * Called every tick, FlushHighlights only does work when the focus changed.
+	 */
+	void PurgeStaleFocus();
+
+	/** Collects the primitives of the given interactable */
+	static void GatherPrimitives(UObject* Interactable, TSet<UPrimitiveComponent*>& OutPrimitives);
+
+	/** Highlights the given primitive and remembers its previous settings */
+	void HighlightPrimitive(UPrimitiveComponent* Primitive, int32 StencilValue);
+
+	/** Restores the settings the given primitive had before it was highlighted */
+	void RestorePrimitive(UPrimitiveComponent* Primitive, const FSavedRenderState& SavedState);
+
+private:
+	/** Focused interactables, by focus owner */
+	TMap<TObjectKey<UObject>, TArray<TWeakObjectPtr<UObject>>> FocusedInteractables;
+
+	/** Highlighted primitives and their settings before they were highlighted */
+	TMap<TWeakObjectPtr<UPrimitiveComponent>, FSavedRenderState> HighlightedPrimitives;
+
+	/** Whether the focus changed since the highlights were last updated */
+	bool bHighlightsDirty = false;
+
+	/** Number of primitives whose render state was changed */
+	int32 NumRenderStateChanges = 0;
+};
@@ -5,6 +5,8 @@
 #include "GameplayAbilitySpecHandle.h"
 #include "Abilities/GameplayAbility.h"
 #include "AbilitySystemComponent.h"
+#include "GameplayTagContainer.h"
+#include "InteractionTagRequirements.h"
 
 #include "InteractionOption.generated.h"
 
@@ -24,6 +26,10 @@ public:
 	UPROPERTY(BlueprintReadWrite, Category = Interaction)
 	TScriptInterface<IInteractableTarget> InteractableTarget;
 
+	/** The instance of the interactable target this option belongs to (e.g. an instanced static mesh instance). INDEX_NONE if the target isn't instanced. */
+	UPROPERTY(BlueprintReadOnly, Category = Interaction)
+	int32 InteractableInstanceIndex = INDEX_NONE;
+
 	/** Simple text the interaction might return */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Interaction)
 	FText Text;
@@ -42,6 +48,14 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Interaction)
 	TSubclassOf<UGameplayAbility> InteractionAbilityToGrant;
 
+	/**
+	 * Soft variant of InteractionAbilityToGrant, so interactables don't hard-load their ability and its assets with the level.
+	 * Streamed in once the interactable is within the prefetch radius of a player, the ability is granted once it is loaded.
+	 * Only used if InteractionAbilityToGrant isn't set.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Interaction)
+	TSoftClassPtr<UGameplayAbility> SoftInteractionAbilityToGrant;
+
 	// - OR -
 	/** The ability system on the target that can be used for the TargetInteractionHandle and sending the event, if needed. */
 	UPROPERTY(BlueprintReadOnly, Category = Interaction)
@@ -55,11 +69,35 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Interaction)
 	TSoftClassPtr<UUserWidget> InteractionWidgetClass;
 
+	/** Generic tags describing this interaction. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Interaction)
+	FGameplayTagContainer InteractionTags;
+
+	/** Time the interaction has to be held to complete, 0 for instant interactions. See UInteractionProgressSubsystem. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Interaction, meta = (ClampMin = 0, Units = "s"))
+	float HoldDuration = 0.f;
+
+	/** Tags the querying ability system has to own, or must not own, for this option to be offered. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Interaction)
+	FInteractionTagRequirements TagRequirements;
+
+	/** The option template this option was created from, if any. */
+	UPROPERTY(BlueprintReadOnly, Category = Interaction)
+	FGameplayTag OptionTemplateId;
+
 public:
+	/** Returns the ability to grant the avatar, nullptr if there is none or its soft reference isn't loaded yet */
+	TSubclassOf<UGameplayAbility> GetInteractionAbilityToGrant() const
+	{
+		return InteractionAbilityToGrant ? InteractionAbilityToGrant : TSubclassOf<UGameplayAbility>(SoftInteractionAbilityToGrant.Get());
+	}
+
 	FORCEINLINE bool operator==(const FInteractionOption& Other) const
 	{
 		return InteractableTarget == Other.InteractableTarget &&
+			InteractableInstanceIndex == Other.InteractableInstanceIndex &&
 			InteractionAbilityToGrant == Other.InteractionAbilityToGrant &&
+			SoftInteractionAbilityToGrant == Other.SoftInteractionAbilityToGrant &&
 			TargetAbilitySystem == Other.TargetAbilitySystem &&
 			TargetInteractionAbilityHandle == Other.TargetInteractionAbilityHandle &&
 			InteractionWidgetClass == Other.InteractionWidgetClass;
@@ -72,14 +110,21 @@ public:
 
 	FORCEINLINE bool operator<(const FInteractionOption& Other) const
 	{
-		return InteractableTarget.GetInterface() < Other.InteractableTarget.GetInterface();
+		if (InteractableTarget.GetInterface() != Other.InteractableTarget.GetInterface())
+		{
+			return InteractableTarget.GetInterface() < Other.InteractableTarget.GetInterface();
+		}
+
+		return InteractableInstanceIndex < Other.InteractableInstanceIndex;
 	}
 
 	FORCEINLINE friend uint32 GetTypeHash(FInteractionOption const& This)
 	{
 		uint32 Hash = 0;
 		Hash = HashCombine(Hash, GetTypeHash(This.InteractableTarget));
+		Hash = HashCombine(Hash, GetTypeHash(This.InteractableInstanceIndex));
 		Hash = HashCombine(Hash, GetTypeHash(This.InteractionAbilityToGrant));
+		Hash = HashCombine(Hash, GetTypeHash(This.SoftInteractionAbilityToGrant));
 		Hash = HashCombine(Hash, GetTypeHash(This.TargetAbilitySystem));
 		Hash = HashCombine(Hash, GetTypeHash(This.TargetInteractionAbilityHandle));
 		Hash = HashCombine(Hash, GetTypeHash(This.InteractionWidgetClass));
@@ -88,7 +133,7 @@ public:
 
 	FORCEINLINE FString ToString() const
 	{
-		return FString::Printf(TEXT("InteractableTarget: %s, InteractionAbilityToGrant: %s, TargetAbilitySystem: %s, TargetInteractionAbilityHandle: %s, InteractionWidgetClass: %s"),
-			*GetNameSafe(InteractableTarget.GetObject()), *GetNameSafe(InteractionAbilityToGrant), *GetNameSafe(TargetAbilitySystem), *TargetInteractionAbilityHandle.ToString(), *InteractionWidgetClass.ToString());
+		return FString::Printf(TEXT("InteractableTarget: %s, InteractableInstanceIndex: %d, InteractionAbilityToGrant: %s, SoftInteractionAbilityToGrant: %s, TargetAbilitySystem: %s, TargetInteractionAbilityHandle: %s, InteractionWidgetClass: %s"),
+			*GetNameSafe(InteractableTarget.GetObject()), InteractableInstanceIndex, *GetNameSafe(InteractionAbilityToGrant), *SoftInteractionAbilityToGrant.ToString(), *GetNameSafe(TargetAbilitySystem), *TargetInteractionAbilityHandle.ToString(), *InteractionWidgetClass.ToString());
 	}
 };
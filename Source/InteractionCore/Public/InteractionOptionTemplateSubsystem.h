@@ -0,0 +1,67 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "InteractionOption.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+
+#include "InteractionOptionTemplateSubsystem.generated.h"
+
+class UInteractionOptionTemplates;
+class UObject;
+struct FStreamableHandle;
+
+/**
+ * Subsystem that loads all interaction option templates once and keeps the resolved options around.
+ * Interactables can then refer to a template by its id instead of building the option on every scan.
+ */
+UCLASS()
+class INTERACTIONCORE_API UInteractionOptionTemplateSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UInteractionOptionTemplateSubsystem();
+	static UInteractionOptionTemplateSubsystem* Get(const UObject* WorldContextObject);
+
+	//~ Begin USubsystem Interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~ End USubsystem Interface
+
+	/** Returns the resolved option for the given template id, nullptr if there is no such template. */
+	const FInteractionOption* FindOptionTemplate(const FGameplayTag& TemplateId) const;
+
+	/** Reloads all option template assets. */
+	void ReloadTemplates();
+
+private:
+	/** Rebuilds the resolved options from the loaded template assets */
+	void RebuildResolvedOptions();
+
+#if WITH_EDITOR
+	/** Called when any object property changed, used to hot-reload edited templates */
+	void OnObjectPropertyChanged(UObject* Object, struct FPropertyChangedEvent& PropertyChangedEvent);
+#endif
+
+private:
+	/** All loaded template assets */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UInteractionOptionTemplates>> TemplateAssets;
+
+	/** The resolved options, by template id */
+	UPROPERTY(Transient)
+	TMap<FGameplayTag, FInteractionOption> ResolvedOptions;
+
+	/** Handle keeping the template assets loaded */
+	TSharedPtr<FStreamableHandle> TemplatesHandle;
+
+	/** Handle keeping the widget classes of all templates loaded */
+	TSharedPtr<FStreamableHandle> WidgetClassesHandle;
+
+#if WITH_EDITOR
+	FDelegateHandle ObjectPropertyChangedHandle;
+#endif
+};
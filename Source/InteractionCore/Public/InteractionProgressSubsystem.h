@@ -0,0 +1,126 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "InteractionProgressSubsystem.generated.h"
+
+class AActor;
+class UObject;
+
+/** Called when an interaction in progress completed or was cancelled. */
+DECLARE_MULTICAST_DELEGATE_TwoParams(FInteractionProgressEndedDelegate, int32 /*ProgressHandle*/, bool /*bCompleted*/);
+
+/**
+ * World subsystem advancing all hold and progress interactions in one batched update, instead of every ability ticking its own timer.
+ *
+ * Interactions are kept in a contiguous array and cancelled as soon as the instigator leaves the range of the target, using the bounds
+ * stored in the interactable index. Completion and cancellation are reported through gameplay events sent to the instigator,
+ * batched after each update, so abilities only have to wait for the event.
+ */
+UCLASS()
+class INTERACTIONCORE_API UInteractionProgressSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UInteractionProgressSubsystem();
+	static UInteractionProgressSubsystem* Get(const UObject* WorldContextObject);
+
+	//~ Begin UWorldSubsystem Interface
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~ End UWorldSubsystem Interface
+
+	//~ Begin FTickableGameObject Interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~ End FTickableGameObject Interface
+
+	/**
+	 * Starts a progress interaction.
+	 *
+	 * @param Instigator The avatar performing the interaction, receives the gameplay events.
+	 * @param Target The interactable target object.
+	 * @param InstanceIndex The instance of the target, INDEX_NONE if the target isn't instanced.
+	 * @param Duration Time until the interaction completes, e.g. FInteractionOption::HoldDuration.
+	 * @param MaxRange The interaction is cancelled once the instigator is farther than this from the bounds of the target.
+	 * @param CompletedEventTag Gameplay event sent to the instigator once the interaction completed.
+	 * @param CancelledEventTag Gameplay event sent to the instigator if the interaction was cancelled.
+	 * @return Handle of the interaction, INDEX_NONE if it couldn't be started.
+	 */
+	UFUNCTION(BlueprintCallable, Category = Interaction)
+	int32 StartProgress(AActor* Instigator, UObject* Target, int32 InstanceIndex, float Duration, float MaxRange, FGameplayTag CompletedEventTag, FGameplayTag CancelledEventTag);
+
+	/** Cancels an interaction in progress, sending its cancelled event */
+	UFUNCTION(BlueprintCallable, Category = Interaction)
+	void CancelProgress(int32 ProgressHandle);
+
+	/** Returns the progress of an interaction from 0 to 1, -1 if there is no such interaction */
+	UFUNCTION(BlueprintPure, Category = Interaction)
+	float GetProgress(int32 ProgressHandle) const;
+
+	/** Returns the number of interactions in progress */
+	int32 GetNumInProgress() const { return InProgress.Num(); }
+
+	/** Called after each update for every interaction that completed or was cancelled */
+	FInteractionProgressEndedDelegate OnProgressEnded;
+
+private:
+	/** A single interaction in progress */
+	struct FInteractionProgress
+	{
+		int32 Handle = INDEX_NONE;
+		float Elapsed = 0.f;
+		float Duration = 0.f;
+		float MaxRange = 0.f;
+
+		/** Bounds of the target as stored in the interactable index, or its current bounds if it isn't indexed */
+		FBox TargetBounds = FBox(ForceInit);
+
+		/** Whether the target was found in the interactable index, its actor is followed otherwise */
+		bool bIndexed = false;
+
+		/** Whether the target reports IInteractableTarget::IsMovingInteractable, it is always followed then */
+		bool bMoving = false;
+
+		TWeakObjectPtr<AActor> Instigator;
+		TWeakObjectPtr<UObject> Target;
+		int32 InstanceIndex = INDEX_NONE;
+
+		FGameplayTag CompletedEventTag;
+		FGameplayTag CancelledEventTag;
+	};
+
+	/** An interaction that ended during the update, waiting for its event to be sent */
+	struct FEndedProgress
+	{
+		FInteractionProgress Progress;
+		bool bCompleted = false;
+	};
+
+	/**
+	 * Resolves the bounds of the target of the given interaction, returns false if it is out of range or gone.
+	 * Targets that aren't indexed are followed through their actor, unless the index is looked up and has them by now.
+	 */
+	bool ResolveTarget(FInteractionProgress& Progress, const FVector& InstigatorLocation, bool bLookUpIndex) const;
+
+	/** Sends the gameplay events of all ended interactions */
+	void DispatchEndedProgress();
+
+private:
+	/** All interactions in progress */
+	TArray<FInteractionProgress> InProgress;
+
+	/** Interactions that ended since the events were last sent */
+	TArray<FEndedProgress> EndedProgress;
+
+	/** Revision of the interactable index when the targets were last resolved */
+	uint32 ResolvedIndexRevision = 0;
+
+	/** Handle of the next interaction */
+	int32 NextHandle = 0;
+};
@@ -0,0 +1,79 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidgetPool.h"
+#include "Subsystems/LocalPlayerSubsystem.h"
+
+#include "InteractionPromptWidgetSubsystem.generated.h"
+
+class APlayerController;
+class UUserWidget;
+class UObject;
+struct FInteractionOption;
+struct FStreamableHandle;
+
+/**
+ * Local player subsystem that manages interaction prompt widgets.
+ * Widget classes are loaded asynchronously ahead of time and a pool of prompt widgets is kept per class,
+ * so showing a prompt never causes a synchronous load or a CreateWidget call on the hot path.
+ */
+UCLASS()
+class INTERACTIONCORE_API UInteractionPromptWidgetSubsystem : public ULocalPlayerSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UInteractionPromptWidgetSubsystem();
+
+	/** Returns the prompt widget subsystem of the local player owning the given controller, nullptr for non-local controllers. */
+	static UInteractionPromptWidgetSubsystem* Get(const APlayerController* PlayerController);
+
+	//~ Begin USubsystem Interface
+	virtual void Deinitialize() override;
+	//~ End USubsystem Interface
+
+	/** Starts loading the given widget class asynchronously and prewarms its pool once loaded. */
+	UFUNCTION(BlueprintCallable, Category = Interaction)
+	void PreloadWidgetClass(TSoftClassPtr<UUserWidget> WidgetClass);
+
+	/** Starts loading the widget classes of all the given options. */
+	void PreloadWidgetClasses(const TArray<FInteractionOption>& Options);
+
+	/**
+	 * Returns a pooled prompt widget of the given class.
+	 * Returns nullptr, and starts loading the class, if the class isn't loaded yet.
+	 */
+	UFUNCTION(BlueprintCallable, Category = Interaction)
+	UUserWidget* AcquirePromptWidget(TSoftClassPtr<UUserWidget> WidgetClass);
+
+	/** Returns a prompt widget to the pool. */
+	UFUNCTION(BlueprintCallable, Category = Interaction)
+	void ReleasePromptWidget(UUserWidget* Widget);
+
+protected:
+	/** Called when a widget class finished loading */
+	void OnWidgetClassLoaded(TSoftClassPtr<UUserWidget> WidgetClass);
+
+	/** Fills the pool with inactive instances of the given class */
+	void PrewarmPool(TSubclassOf<UUserWidget> WidgetClass);
+
+	/** Makes sure the pool creates its widgets for the current player controller, returns false if there is none */
+	bool UpdatePoolOwner();
+
+private:
+	/** The pool of prompt widgets, for all classes */
+	UPROPERTY(Transient)
+	FUserWidgetPool PromptWidgetPool;
+
+	/** Widget classes that finished loading, kept alive for the lifetime of the subsystem */
+	UPROPERTY(Transient)
+	TArray<TSubclassOf<UUserWidget>> LoadedWidgetClasses;
+
+	/** The player controller the pooled widgets were created for */
+	TWeakObjectPtr<APlayerController> PoolOwner;
+
+	/** Pending async loads, by widget class */
+	TMap<FSoftObjectPath, TSharedPtr<FStreamableHandle>> PendingLoads;
+};
@@ -2,8 +2,14 @@
 
 #pragma once
 
+#include "GameplayTagContainer.h"
+#include "InteractableIndexTypes.h"
+#include "InteractionTagRequirements.h"
+
 #include "InteractionQuery.generated.h"
 
+class UAbilitySystemComponent;
+
 /** Defines a single query for interaction */
 USTRUCT(BlueprintType)
 struct FInteractionQuery
@@ -22,4 +28,59 @@ public:
 	/** A generic UObject to store extra data required for the interaction */
 	UPROPERTY(BlueprintReadWrite)
 	TWeakObjectPtr<UObject> OptionalObjectData;
+
+	/** Only interactables in at least one of these categories are considered, all interactables if empty */
+	UPROPERTY(BlueprintReadWrite)
+	FGameplayTagContainer IncludeCategories;
+
+	/** Interactables in any of these categories are never considered */
+	UPROPERTY(BlueprintReadWrite)
+	FGameplayTagContainer ExcludeCategories;
+
+	/** The category tags compiled into masks, see CompileCategoryFilter */
+	FInteractableCategoryFilter CategoryFilter;
+
+	/** Owned tags of the requesting ability system, options are filtered by their tag requirements if set */
+	TOptional<FInteractionTagBits> RequestingTags;
+
+	//////////////////////////////////////////////////////////////////////////
+	/// SNAPSHOT
+	/// Resolved once per scan by BuildSnapshot, so targets don't have to resolve the weak pointers or look up the view themselves.
+
+	/** The ability system of the requester */
+	UPROPERTY(BlueprintReadOnly, Transient)
+	TObjectPtr<UAbilitySystemComponent> RequestingAbilitySystem = nullptr;
+
+	/** World location of the requesting avatar */
+	UPROPERTY(BlueprintReadOnly)
+	FVector AvatarLocation = FVector::ZeroVector;
+
+	/** Origin of the view of the requester, the eyes of the avatar if there is no controller */
+	UPROPERTY(BlueprintReadOnly)
+	FVector ViewLocation = FVector::ZeroVector;
+
+	/** Direction of the view of the requester */
+	UPROPERTY(BlueprintReadOnly)
+	FVector ViewDirection = FVector::ForwardVector;
+
+	/** Generic team id of the requester, 255 (no team) if neither the controller nor the pawn has a team */
+	UPROPERTY(BlueprintReadOnly)
+	uint8 RequestingTeamId = 255;
+
+	/** Whether the snapshot was built */
+	UPROPERTY(BlueprintReadOnly)
+	bool bHasSnapshot = false;
+
+public:
+	/** Compiles the include and exclude categories into the category filter, has to be called whenever they change */
+	INTERACTIONCORE_API void CompileCategoryFilter();
+
+	/**
+	 * Resolves the requester into the snapshot, should be called once per scan before gathering options.
+	 * Falls back to the avatar of the given ability system if there is no requesting pawn.
+	 *
+	 * @param AbilitySystem The ability system of the requester.
+	 * @param OwnedTags The owned tags of the ability system, the requesting tags are left alone if nullptr.
+	 */
+	INTERACTIONCORE_API void BuildSnapshot(UAbilitySystemComponent* AbilitySystem, const FInteractionTagBits* OwnedTags = nullptr);
 };
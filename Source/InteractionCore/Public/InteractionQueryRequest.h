@@ -0,0 +1,70 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "InteractionOption.h"
+#include "InteractionQuery.h"
+#include "Tasks/Task.h"
+
+class AActor;
+class UAbilitySystemComponent;
+class UWorld;
+
+/** How an interaction query request finds its interactables */
+enum class EInteractionQueryRequestShape : uint8
+{
+	/** All indexed interactables whose bounds intersect a sphere around the location */
+	Sphere,
+
+	/** The interactable hit by an asynchronous line trace through the physics scene, from the location to the trace end */
+	LineTrace
+};
+
+/**
+ * A standalone interaction query, for gameplay code that needs a one-off "what can I interact with here" answer
+ * without creating and activating an ability task. Creates no UObjects, so scripted and AI systems can issue many at once.
+ *
+ * Launching a request chains its stages as task dependencies: the spatial query runs on worker threads per index cell
+ * (or as an async physics trace), the results are merged on a worker, and only gathering and filtering the options,
+ * which calls into UObjects, runs in a game thread task.
+ *
+ * Never wait on the returned task from the game thread, its last stage runs there. Chain a continuation instead.
+ */
+struct INTERACTIONCORE_API FInteractionQueryRequest
+{
+	/** The query the options are gathered with. The snapshot is built when the options are gathered, unless it already was. */
+	FInteractionQuery Query;
+
+	/** The ability system of the requester, options are resolved and filtered against its abilities */
+	TWeakObjectPtr<UAbilitySystemComponent> AbilitySystem;
+
+	/** How interactables are found */
+	EInteractionQueryRequestShape Shape = EInteractionQueryRequestShape::Sphere;
+
+	/** Center of the sphere, or start of the trace */
+	FVector Location = FVector::ZeroVector;
+
+	/** Radius of the sphere */
+	double Radius = 500.0;
+
+	/** Maximum number of interactables the options are gathered from, the closest ones are kept */
+	int32 MaxInteractables = 8;
+
+	/** End of the trace */
+	FVector TraceEnd = FVector::ZeroVector;
+
+	/** Channel of the trace */
+	TEnumAsByte<ECollisionChannel> TraceChannel = ECC_Visibility;
+
+	/** Actor ignored by the trace, usually the avatar of the requester */
+	TWeakObjectPtr<const AActor> IgnoredActor;
+
+	/**
+	 * Launches the request. Has to be called on the game thread.
+	 *
+	 * @return Task resolving to the options the requester can activate right now, empty if the world or the ability system went away.
+	 */
+	UE::Tasks::TTask<TArray<FInteractionOption>> Launch(UWorld* World) const;
+};
@@ -0,0 +1,114 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InteractionTraceCache.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/WeakInterfacePtr.h"
+
+#include "InteractionScanSubsystem.generated.h"
+
+class AActor;
+class IInteractionScanner;
+class UObject;
+struct FInteractionScanResult;
+struct FInteractionScanSignificanceInputs;
+
+/** Significance tiers an interaction scanner can be in */
+UENUM(BlueprintType)
+enum class EInteractionScanSignificance : uint8
+{
+	/** Scans at the baseline scan rate */
+	High,
+
+	/** Scans at the medium significance scale of the baseline scan rate */
+	Medium,
+
+	/** Scans at the low significance scale of the baseline scan rate */
+	Low
+};
+
+/**
+ * World subsystem that schedules all interaction scanners.
+ * The baseline scan rate of each scanner is scaled by its significance tier and due scanners are run
+ * in order of significance, so that a limited per-frame scan budget is spent where players notice it.
+ */
+UCLASS()
+class INTERACTIONCORE_API UInteractionScanSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UInteractionScanSubsystem();
+	static UInteractionScanSubsystem* Get(const UObject* WorldContextObject);
+
+	//~ Begin FTickableGameObject Interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~ End FTickableGameObject Interface
+
+	/**
+	 * Registers a scanner with this subsystem.
+	 *
+	 * @param Scanner The scanner to register, must implement IInteractionScanner.
+	 * @param bScanImmediately If true, the scanner will be considered due on the next tick.
+	 */
+	void RegisterScanner(UObject* Scanner, bool bScanImmediately = false);
+
+	/** Unregisters a scanner from this subsystem. */
+	void UnregisterScanner(UObject* Scanner);
+
+	/**
+	 * Finds the most recent scan result of any scanner running for the given avatar.
+	 *
+	 * @param Avatar The avatar to find the scan result for.
+	 * @param MaxAge The maximum age of the scan result in seconds.
+	 * @param OutResult The found scan result.
+	 * @return True if a scan result that is fresh enough was found.
+	 */
+	bool FindLatestScanResult(const AActor* Avatar, double MaxAge, FInteractionScanResult& OutResult) const;
+
+	/** Returns the cache of traces performed this frame for the given avatar. Shared by all interaction tasks on that avatar. */
+	FInteractionTraceCache& GetTraceCache(const AActor* Avatar);
+
+	/** Returns the significance tier a scanner was last put into. */
+	EInteractionScanSignificance GetScannerSignificance(const UObject* Scanner) const;
+
+	/** Computes the significance score for the given inputs. */
+	static float ComputeSignificance(const FInteractionScanSignificanceInputs& Inputs);
+
+	/** Maps a significance score to its tier. */
+	static EInteractionScanSignificance GetSignificanceTier(float Significance);
+
+	/** Returns the scale applied to the baseline scan interval for the given tier. */
+	static float GetSignificanceIntervalScale(EInteractionScanSignificance Tier);
+
+private:
+	/** A single registered scanner */
+	struct FRegisteredScanner
+	{
+		TWeakInterfacePtr<IInteractionScanner> Scanner;
+
+		/** World time at which the scanner is due again */
+		double NextScanTime = 0.0;
+
+		/** Significance computed after the last scan */
+		float Significance = 0.f;
+
+		/** Tier computed after the last scan */
+		EInteractionScanSignificance Tier = EInteractionScanSignificance::High;
+	};
+
+	/** Computes significance and next scan time after a scanner has scanned */
+	void UpdateScannerSchedule(FRegisteredScanner& Entry, double CurrentTime) const;
+
+	/** List of all registered scanners */
+	TArray<FRegisteredScanner> RegisteredScanners;
+
+	/** Per-avatar caches of the traces performed this frame */
+	TMap<TObjectKey<AActor>, FInteractionTraceCache> TraceCaches;
+
+	/** Scratch list of due scanner indices, kept around to avoid reallocating every frame */
+	TArray<TPair<float, int32>> DueScanners;
+};
@@ -10,9 +10,13 @@ template <typename InterfaceType> class TScriptInterface;
 
 class AActor;
 class IInteractableTarget;
+class UAbilitySystemComponent;
 class UObject;
 struct FFrame;
+struct FGameplayTagContainer;
 struct FHitResult;
+struct FInteractableIndexEntry;
+struct FInteractionOption;
 struct FOverlapResult;
 
 /**
@@ -34,7 +38,33 @@ public:
 	UFUNCTION(BlueprintCallable, Category = Interaction)
 	static void GetInteractableTargetsFromActor(AActor* Actor, TArray<TScriptInterface<IInteractableTarget>>& OutInteractableTargets);
 
+	/**
+	 * Returns the indexed interactables closest to the given location, sorted by distance.
+	 * OutInstanceIndices holds the instance of each interactable, INDEX_NONE if it isn't instanced.
+	 */
+	UFUNCTION(BlueprintCallable, Category = Interaction, meta = (WorldContext = "WorldContextObject", AutoCreateRefTerm = "IncludeCategories,ExcludeCategories"))
+	static void FindNearestInteractables(const UObject* WorldContextObject, FVector Location, float MaxDistance, int32 MaxCount, const FGameplayTagContainer& IncludeCategories, const FGameplayTagContainer& ExcludeCategories, TArray<TScriptInterface<IInteractableTarget>>& OutInteractableTargets, TArray<int32>& OutInstanceIndices);
+
+	/**
+	 * Validates an interaction against where the target was at the given server world time, so interactions with moving targets
+	 * are judged by what the client saw. See UInteractableIndexSubsystem::ValidateInteraction.
+	 */
+	UFUNCTION(BlueprintCallable, Category = Interaction)
+	static bool ValidateInteraction(const AActor* Instigator, const TScriptInterface<IInteractableTarget>& InteractableTarget, int32 InstanceIndex, double ServerWorldTime, float MaxRange, bool bCheckLineOfSight = true);
+
 public:
 	static void AppendInteractableTargetsFromOverlapResults(const TArray<FOverlapResult>& OverlapResults, TArray<TScriptInterface<IInteractableTarget>>& OutInteractableTargets);
 	static void AppendInteractableTargetsFromHitResult(const FHitResult& HitResult, TArray<TScriptInterface<IInteractableTarget>>& OutInteractableTargets);
+
+	/** Returns the interactable instance that was hit (instanced static mesh or light weight instance), INDEX_NONE if the hit isn't instanced. */
+	static int32 GetInteractableInstanceIndexFromHitResult(const FHitResult& HitResult);
+
+	/** Builds a blocking hit on the given interactable index entry, so it resolves to the same interactable as a physics hit would. */
+	static void MakeHitResultFromIndexEntry(const FInteractableIndexEntry& Entry, const FVector& Start, const FVector& End, double Distance, FHitResult& OutHitResult);
+
+	/**
+	 * Resolves the ability spec the given option activates and returns whether the requester can activate it right now.
+	 * Options granting an ability to the requester are updated to activate it on the given ability system.
+	 */
+	static bool ResolveInteractionOptionAbility(UAbilitySystemComponent* AbilitySystem, FInteractionOption& Option);
 };
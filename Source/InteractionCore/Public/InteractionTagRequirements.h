@@ -0,0 +1,130 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+
+#include "InteractionTagRequirements.generated.h"
+
+class UAbilitySystemComponent;
+
+/**
+ * Dense bitset over all registered gameplay tags, with one bit per tag at its network index.
+ * Testing two bitsets against each other only takes a few word-wide ANDs, unlike testing tag containers.
+ */
+struct INTERACTIONCORE_API FInteractionTagBits
+{
+	/** Builds the bits of the given tags, optionally including all of their parents */
+	static FInteractionTagBits MakeFromTags(const FGameplayTagContainer& Tags, bool bIncludeParents);
+
+	/** Sets the bit of a single tag */
+	void AddTag(const FGameplayTag& Tag);
+
+	/** Returns whether all bits of the given bitset are set in this one */
+	bool HasAll(const FInteractionTagBits& Other) const
+	{
+		for (int32 WordIdx = 0; WordIdx < Other.Words.Num(); ++WordIdx)
+		{
+			const uint64 Word = Words.IsValidIndex(WordIdx) ? Words[WordIdx] : 0;
+			if ((Other.Words[WordIdx] & ~Word) != 0)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/** Returns whether any bit of the given bitset is set in this one */
+	bool HasAny(const FInteractionTagBits& Other) const
+	{
+		const int32 NumWords = FMath::Min(Words.Num(), Other.Words.Num());
+		for (int32 WordIdx = 0; WordIdx < NumWords; ++WordIdx)
+		{
+			if ((Words[WordIdx] & Other.Words[WordIdx]) != 0)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool IsEmpty() const { return Words.Num() == 0; }
+
+	void Reset() { Words.Reset(); }
+
+	/** Incremented whenever the gameplay tag tree changed, which invalidates all previously built bits */
+	static uint32 GetTagUniverseSerial();
+
+private:
+	/** Enough inline words for the first 256 tags */
+	TArray<uint64, TInlineAllocator<4>> Words;
+};
+
+/**
+ * Tags the querying ability system has to own, or must not own, for an interaction option to be offered.
+ * Compiled once into tag bits, so checking the requirements of an option is nearly free.
+ */
+USTRUCT(BlueprintType)
+struct INTERACTIONCORE_API FInteractionTagRequirements
+{
+	GENERATED_BODY()
+
+public:
+	/** The querying ability system needs all of these tags */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Interaction)
+	FGameplayTagContainer RequiredTags;
+
+	/** The querying ability system must not have any of these tags */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Interaction)
+	FGameplayTagContainer BlockedTags;
+
+public:
+	/** Compiles the tags into bits. Only has to be called after changing the tags, they are compiled on first use otherwise. */
+	void Compile() const;
+
+	/** Returns whether the given owned tag bits (including parents) satisfy the requirements */
+	bool IsSatisfiedBy(const FInteractionTagBits& OwnedTagBits) const
+	{
+		if (RequiredTags.IsEmpty() && BlockedTags.IsEmpty())
+		{
+			return true;
+		}
+
+		if (CompiledSerial != FInteractionTagBits::GetTagUniverseSerial())
+		{
+			Compile();
+		}
+
+		return OwnedTagBits.HasAll(RequiredTagBits) && !OwnedTagBits.HasAny(BlockedTagBits);
+	}
+
+private:
+	mutable FInteractionTagBits RequiredTagBits;
+	mutable FInteractionTagBits BlockedTagBits;
+
+	/** Tag universe the bits were compiled for, 0 if they aren't compiled */
+	mutable uint32 CompiledSerial = 0;
+};
+
+/** Caches the owned tags of an ability system as tag bits, rebuilt only after its tags changed. */
+class INTERACTIONCORE_API FInteractionOwnedTagBits
+{
+public:
+	~FInteractionOwnedTagBits();
+
+	/** Returns the owned tag bits of the given ability system, including the parents of all owned tags */
+	const FInteractionTagBits& Get(UAbilitySystemComponent* AbilitySystem);
+
+	/** Stops listening for tag changes */
+	void Reset();
+
+private:
+	void OnTagChanged(const FGameplayTag Tag, int32 NewCount);
+
+	TWeakObjectPtr<UAbilitySystemComponent> BoundAbilitySystem;
+	FDelegateHandle TagChangedHandle;
+	FInteractionTagBits Bits;
+	uint32 BuiltSerial = 0;
+	bool bDirty = true;
+};
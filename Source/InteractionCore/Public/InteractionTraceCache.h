@@ -0,0 +1,57 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/HitResult.h"
+
+struct FCollisionQueryParams;
+
+/** Identifies a single interaction trace. Two traces with the same key issued in the same frame produce the same hit. */
+struct FInteractionTraceKey
+{
+	FInteractionTraceKey() = default;
+	FInteractionTraceKey(const FVector& InStart, const FVector& InEnd, FName InProfileName, const FCollisionQueryParams& Params);
+
+	FVector Start = FVector::ZeroVector;
+	FVector End = FVector::ZeroVector;
+	FName ProfileName;
+
+	/** Hash of the ignored actors and components, as well as the trace complexity */
+	uint32 ParamsHash = 0;
+
+	bool operator==(const FInteractionTraceKey& Other) const
+	{
+		return ParamsHash == Other.ParamsHash &&
+			ProfileName == Other.ProfileName &&
+			Start.Equals(Other.Start, 0.) &&
+			End.Equals(Other.End, 0.);
+	}
+};
+
+/**
+ * Per-avatar cache of the interaction traces performed this frame.
+ * Used to share identical traces between multiple interaction tasks running on the same avatar.
+ */
+class INTERACTIONCORE_API FInteractionTraceCache
+{
+public:
+	/** Returns the cached hit for the given trace, or nullptr if the trace hasn't been performed this frame. */
+	const FHitResult* Find(const FInteractionTraceKey& Key);
+
+	/** Stores the hit for the given trace for the rest of this frame. */
+	void Add(const FInteractionTraceKey& Key, const FHitResult& Hit);
+
+	/** Returns whether the cached traces were performed on a previous frame. */
+	bool IsStale() const { return FrameNumber != GFrameCounter; }
+
+private:
+	/** Drops all cached traces if they were performed on a previous frame */
+	void ResetIfStale();
+
+	/** The frame the cached traces were performed on */
+	uint64 FrameNumber = 0;
+
+	/** Traces performed this frame. There are only ever a handful, so a linear search is fine */
+	TArray<TPair<FInteractionTraceKey, FHitResult>, TInlineAllocator<4>> Entries;
+};
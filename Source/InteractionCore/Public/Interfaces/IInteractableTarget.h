@@ -10,6 +10,8 @@
 
 struct FGameplayEventData;
 struct FGameplayTag;
+struct FGameplayTagContainer;
+struct FInteractableIndexEntry;
 struct FInteractionQuery;
 class IInteractableTarget;
 
@@ -19,22 +21,65 @@ class FInteractionOptionsBuilder
 public:
 	FInteractionOptionsBuilder(
 		const TScriptInterface<IInteractableTarget>& InteractableTarget
-		, TArray<FInteractionOption>& InteractOptions)
+		, TArray<FInteractionOption>& InteractOptions
+		, int32 InInstanceIndex = INDEX_NONE
+		, const FInteractionTagBits* InRequestingTags = nullptr)
 		: Interactable(InteractableTarget)
 		, Options(InteractOptions)
+		, InstanceIndex(InInstanceIndex)
+		, RequestingTags(InRequestingTags)
 	{
 	}
 
-	/** Adds a single interaction option to the list of options */
-	void AddInteractionOption(const FInteractionOption& Option) const
+	/**
+	 * Adds a single interaction option to the list of options.
+	 * Options whose tag requirements aren't met by the requesting ability system are skipped.
+	 *
+	 * @return True if the option was added.
+	 */
+	bool AddInteractionOption(const FInteractionOption& Option) const
 	{
+		if (!MeetsTagRequirements(Option))
+		{
+			return false;
+		}
+
 		FInteractionOption& OptionEntry = Options.Add_GetRef(Option);
 		OptionEntry.InteractableTarget = Interactable;
+		return true;
+	}
+
+	/**
+	 * Returns whether the requesting ability system meets the tag requirements of the given option.
+	 * Checking an option that is kept around caches its compiled requirements, so copies made afterwards don't have to compile them again.
+	 */
+	bool MeetsTagRequirements(const FInteractionOption& Option) const
+	{
+		return RequestingTags == nullptr || Option.TagRequirements.IsSatisfiedBy(*RequestingTags);
 	}
 
+	/**
+	 * Adds the pre-resolved option of an interaction option template to the list of options.
+	 * Much cheaper than building the option from scratch on every scan.
+	 *
+	 * @param TemplateId The id of the template to add.
+	 * @return True if the template was found and its option added.
+	 */
+	INTERACTIONCORE_API bool AddInteractionOptionFromTemplate(const FGameplayTag& TemplateId) const;
+
+	/**
+	 * Returns the instance of the target that is being queried, e.g. the hit instance of an instanced static mesh.
+	 * INDEX_NONE means no specific instance was hit, instanced targets should then report the options of all their instances.
+	 */
+	int32 GetInstanceIndex() const { return InstanceIndex; }
+
 private:
 	TScriptInterface<IInteractableTarget> Interactable;
 	TArray<FInteractionOption>& Options;
+	int32 InstanceIndex;
+
+	/** Owned tags of the requesting ability system, nullptr if options aren't filtered by their tag requirements */
+	const FInteractionTagBits* RequestingTags;
 };
 
 /**
@@ -57,4 +102,52 @@ public:
 
 	/** Called to customize the interaction event data to be sent when the interaction is performed */
 	virtual void CustomizeInteractionEventData(const FGameplayTag& InteractionEventTag, FGameplayEventData& InOutEventData) { }
+
+	/**
+	 * Called to gather the entries this target contributes to the interactable index.
+	 * Defaults to a single entry covering the bounds of the target component or its owning actor.
+	 */
+	virtual void GatherInteractableIndexEntries(TArray<FInteractableIndexEntry>& OutEntries) const;
+
+	/**
+	 * Called to gather the entries of a single instance of this target, when only that instance changed.
+	 * Defaults to gathering all entries and keeping the ones of the instance.
+	 */
+	virtual void GatherInteractableInstanceIndexEntries(int32 InstanceIndex, TArray<FInteractableIndexEntry>& OutEntries) const;
+
+	/**
+	 * Called to gather the tags the interactable categories of this target are derived from when it is registered in the interactable index.
+	 * Defaults to the owned gameplay tags of the target or its owning actor.
+	 */
+	virtual void GetInteractableCategoryTags(FGameplayTagContainer& OutTags) const;
+
+	/**
+	 * Called to get the id of the option template this target provides when it is registered in the interactable index, if it provides a single templated option.
+	 * Stored with its index entries, so the option can be looked up without gathering the options of the target.
+	 */
+	virtual FGameplayTag GetInteractableOptionTemplateId() const { return FGameplayTag(); }
+
+	/**
+	 * Whether this target keeps moving after it was registered in the interactable index, e.g. because it's on a moving platform or vehicle.
+	 * The index then records its transform history, so the server can validate interactions against where clients saw it.
+	 */
+	virtual bool IsMovingInteractable() const { return false; }
+
+	/**
+	 * Claims this target (or one of its instances) for the given claimant, so nobody else is offered its options until the claim is released or expires.
+	 * Nothing in the plugin claims targets, games call this from their interaction abilities when an interaction starts and release the claim when it ends.
+	 *
+	 * Claims are authority-only: they aren't replicated, so claims made on the server are never seen by clients, and remote
+	 * clients keep offering claimed targets until the server rejects the interaction. See UInteractionClaimSubsystem.
+	 *
+	 * @param Claimant Must be the ability system component of the interacting avatar, that's what option gathering compares claims against.
+	 * @return True if the claimant holds the claim.
+	 */
+	bool TryClaimInteraction(const UObject* Claimant, int32 InstanceIndex = INDEX_NONE, float Duration = -1.f) const;
+
+	/** Releases the claim of the given claimant on this target */
+	void ReleaseInteractionClaim(const UObject* Claimant, int32 InstanceIndex = INDEX_NONE) const;
+
+	/** Returns whether anyone but the given claimant holds a claim on this target */
+	bool IsInteractionClaimedByOther(const UObject* Claimant, int32 InstanceIndex = INDEX_NONE) const;
 };
@@ -0,0 +1,69 @@
+// Copyright © 2024 MajorT. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/HitResult.h"
+#include "InteractionOption.h"
+#include "UObject/Interface.h"
+
+#include "IInteractionScanner.generated.h"
+
+class AActor;
+
+/** Inputs used to decide how significant an interaction scanner currently is. */
+struct FInteractionScanSignificanceInputs
+{
+	/** The avatar the scanner is scanning for */
+	const AActor* Avatar = nullptr;
+
+	/** Distance to the nearest interactable found by the last scan, or MAX_flt if none was found */
+	float NearestInteractableDistance = MAX_flt;
+
+	/** Whether the scanner is currently showing an interaction prompt */
+	bool bPromptShown = false;
+};
+
+/** The result of the most recent scan of an interaction scanner. */
+struct FInteractionScanResult
+{
+	/** The avatar the scan was performed for */
+	const AActor* Avatar = nullptr;
+
+	/** The hit of the scan trace */
+	FHitResult Hit;
+
+	/** The options that were found by the scan */
+	TArray<FInteractionOption> Options;
+
+	/** World time the scan was performed at, negative if there was no scan yet */
+	double ScanTime = -1.0;
+};
+
+/**
+ * Interface for objects that periodically scan for interactables.
+ * Scanners register with the UInteractionScanSubsystem, which decides when and in which order they scan.
+ */
+UINTERFACE(meta = (CannotImplementInterfaceInBlueprint))
+class INTERACTIONCORE_API UInteractionScanner : public UInterface
+{
+	GENERATED_BODY()
+};
+
+class INTERACTIONCORE_API IInteractionScanner
+{
+	GENERATED_BODY()
+
+public:
+	/** Called to perform a single scan */
+	virtual void PerformInteractionScan() = 0;
+
+	/** Returns the baseline interval between two scans, which gets scaled by the significance of the scanner */
+	virtual float GetInteractionScanRate() const = 0;
+
+	/** Called to gather the inputs used to compute the significance of this scanner */
+	virtual void GetInteractionScanSignificanceInputs(FInteractionScanSignificanceInputs& OutInputs) const = 0;
+
+	/** Called to retrieve the result of the most recent scan, returns false if the scanner doesn't trace or hasn't scanned yet */
+	virtual bool GetLastInteractionScanResult(FInteractionScanResult& OutResult) const { return false; }
+};
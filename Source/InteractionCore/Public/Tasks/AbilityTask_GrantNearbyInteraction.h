@@ -3,48 +3,162 @@
 #pragma once
 
 #include "Abilities/Tasks/AbilityTask.h"
+#include "InteractableIndexTypes.h"
+#include "Interfaces/IInteractionScanner.h"
 
 #include "AbilityTask_GrantNearbyInteraction.generated.h"
 
+class AActor;
+class IInteractableTarget;
 class UGameplayAbility;
+class UInteractableIndexSubsystem;
 class UObject;
 struct FFrame;
 struct FGameplayAbilitySpecHandle;
+struct FInteractionOption;
+struct FInteractionQuery;
 struct FObjectKey;
 
 UCLASS()
-class INTERACTIONCORE_API UAbilityTask_GrantNearbyInteraction : public UAbilityTask
+class INTERACTIONCORE_API UAbilityTask_GrantNearbyInteraction : public UAbilityTask, public IInteractionScanner
 {
 	GENERATED_BODY()
 
 public:
 	UAbilityTask_GrantNearbyInteraction(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
 
-	/** Waits until an overlap occurs. This will need to be better fleshed out, so we can specify game-specific collision requirements */
-	UFUNCTION(BlueprintCallable, Category = "Ability|Tasks", meta = (HidePin = "OwningAbility", DefaultToSelf = "OwningAbility", BlueprintInternalUseOnly = "true"))
-	static UAbilityTask_GrantNearbyInteraction* GrantAbilitiesForNearbyInteractors(UGameplayAbility* OwningAbility, ECollisionChannel Channel, float InteractionScanRange, float InteractionScanRate, bool bShowDebug = false);
+	/**
+	 * Waits until an overlap occurs. This will need to be better fleshed out, so we can specify game-specific collision requirements.
+	 * Only interactables of the include categories, and none of the exclude categories, get their abilities granted.
+	 *
+	 * @param Channel Only used by the overlap fallback when there is no interactable index (UInteractableIndexSubsystem). Nearby
+	 *                interactables are found in the index otherwise, which ignores collision entirely, use the categories to filter them.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Ability|Tasks", meta = (HidePin = "OwningAbility", DefaultToSelf = "OwningAbility", BlueprintInternalUseOnly = "true", AutoCreateRefTerm = "IncludeCategories,ExcludeCategories"))
+	static UAbilityTask_GrantNearbyInteraction* GrantAbilitiesForNearbyInteractors(UGameplayAbility* OwningAbility, ECollisionChannel Channel, float InteractionScanRange, float InteractionScanRate, bool bShowDebug = false, const FGameplayTagContainer& IncludeCategories = FGameplayTagContainer(), const FGameplayTagContainer& ExcludeCategories = FGameplayTagContainer());
 
 	//~ Begin UAbilityTask Interface
 	virtual void Activate() override;
+	virtual void TickTask(float DeltaTime) override;
 	virtual void OnDestroy(bool bInOwnerFinished) override;
 	//~ End UAbilityTask Interface
 
+	//~ Begin IInteractionScanner Interface
+	virtual void PerformInteractionScan() override;
+	virtual float GetInteractionScanRate() const override { return InteractionScanRate; }
+	virtual void GetInteractionScanSignificanceInputs(FInteractionScanSignificanceInputs& OutInputs) const override;
+	//~ End IInteractionScanner Interface
+
 protected:
 	/** Called to query for interactables */
 	void QueryInteractables();
 
+	/** Called by the interactable index when interactables entered or left the scan range */
+	void OnNearbyInteractablesChanged(const TArray<FInteractableIndexEntry>& Entered, const TArray<FInteractableIndexEntryKey>& Exited);
+
+	/** Replaces the nearby interactables with the nearest ones and gathers the options of those we didn't gather from yet */
+	void RefreshNearestInteractables(UInteractableIndexSubsystem* IndexSubsystem, const FVector& Location);
+
+	/** Gathers the options of interactables ahead of the avatar's movement, so their abilities are granted before they are in range */
+	void PredictNearbyInteractables(UInteractableIndexSubsystem* IndexSubsystem, const AActor* ActorOwner);
+
+	/**
+	 * Streams in the soft-referenced abilities of the nearest interactables within the prefetch radius.
+	 * Interactables reporting an option template (IInteractableTarget::GetInteractableOptionTemplateId) are resolved through the template,
+	 * the options of all others are gathered.
+	 */
+	void PrefetchInteractionAbilities(UInteractableIndexSubsystem* IndexSubsystem, const FVector& Location);
+
+	/** Gathers the options of the given interactables and handles them, bPredicted if they aren't in range yet */
+	void GatherNearbyInteractionOptions(const TArray<FInteractableIndexEntry>& Entries, bool bPredicted = false);
+
+	/** Builds the query used to gather the options of nearby interactables */
+	FInteractionQuery MakeInteractionQuery(AActor* ActorOwner);
+
+	/** Preloads the prompt widgets of the given options and queues their abilities to be granted */
+	void HandleNearbyInteractionOptions(const TArray<FInteractionOption>& InteractOptions, bool bPredicted = false);
+
+	/** Queues an ability to be granted, unless it already was */
+	void QueueAbilityGrant(TSubclassOf<UGameplayAbility> AbilityClass, float Priority);
+
+	/** Queues a soft-referenced ability to be granted, once it streamed in if it isn't loaded yet */
+	void QueueStreamedAbilityGrant(const TSoftClassPtr<UGameplayAbility>& AbilityClass, float Priority);
+
+	/** Called when a soft-referenced ability finished streaming in */
+	void OnAbilityClassStreamed(const TSoftClassPtr<UGameplayAbility>& AbilityClass);
+
+	/** Grants the queued abilities with the highest priority, as many as the grant budget of the frame allows */
+	void GrantDeferredAbilities();
+
 	/** The interaction scan range to use for the line trace */
 	float InteractionScanRange = 0.f;
 
-	/** The interaction scan rate for the interaction */
+	/** The baseline interaction scan rate, scaled by the significance of the scan */
 	float InteractionScanRate = 0.1f;
 
 	/** Whether to draw debug information */
 	bool bShowDebug = false;
 
-	/** The collision channel to use for the line trace */
+	/** The collision channel of the overlap fallback, ignored while the interactable index is observed */
 	ECollisionChannel Channel = ECC_Camera;
 
-	FTimerHandle QueryTimerHandle;
+	/** Distance to the nearest interactable found by the last query, MAX_flt if nothing was found */
+	float NearestInteractableDistance = MAX_flt;
+
 	TMap<FObjectKey, FGameplayAbilitySpecHandle> InteractionAbilityCache;
+
+	/** An ability waiting to be granted */
+	struct FDeferredAbilityGrant
+	{
+		TSubclassOf<UGameplayAbility> AbilityClass;
+
+		/** Grants for interactables in range go before predicted ones */
+		float Priority = 0.f;
+
+		/** Number of frames the grant was deferred for */
+		int32 FramesDeferred = 0;
+	};
+
+	/** Abilities waiting to be granted, a few of them are granted every frame */
+	TArray<FDeferredAbilityGrant> DeferredAbilityGrants;
+
+	/** Priorities of soft-referenced abilities waiting to stream in before they can be granted */
+	TMap<FSoftObjectPath, float> StreamingAbilityGrants;
+
+	/** Handle of our binding to UInteractionAbilityStreamingSubsystem::OnAbilityClassStreamed */
+	FDelegateHandle AbilityStreamedHandle;
+
+	/** Categories of interactables to consider */
+	FGameplayTagContainer IncludeCategories;
+	FGameplayTagContainer ExcludeCategories;
+
+	/** Id of our interactable index observer, INDEX_NONE if we fall back to polling overlaps */
+	int32 IndexObserverId = INDEX_NONE;
+
+	/** Categories compiled into a filter for the interactable index */
+	FInteractableCategoryFilter CategoryFilter;
+
+	/** Locations of the interactables in range, or only of the nearest ones if their number is limited */
+	TMap<FInteractableIndexEntryKey, FVector> NearbyInteractables;
+
+	/** Interactables in range whose options were gathered, if the number of nearby interactables is limited */
+	TSet<FInteractableIndexEntryKey> GatheredInteractables;
+
+	/** Where the nearest interactables were last looked up */
+	FVector NearestInteractablesLocation = FVector::ZeroVector;
+
+	/** Whether interactables entered or left the scan range since the nearest interactables were last looked up */
+	bool bNearestInteractablesDirty = true;
+
+	/** Interactables ahead of the avatar whose options were gathered by the last prediction */
+	TSet<FInteractableIndexEntryKey> PredictedInteractables;
+
+	/** Where the avatar was predicted to be by the last prediction */
+	FVector PredictedInteractablesLocation = FVector(UE_BIG_NUMBER);
+
+	/** Interactables within the prefetch radius whose soft-referenced abilities were streamed in by the last prefetch */
+	TSet<FInteractableIndexEntryKey> PrefetchedInteractables;
+
+	/** Where the last prefetch was done */
+	FVector PrefetchedInteractablesLocation = FVector(UE_BIG_NUMBER);
 };
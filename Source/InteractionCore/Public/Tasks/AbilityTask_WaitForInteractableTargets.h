@@ -18,6 +18,20 @@ struct FHitResult;
 struct FInteractionQuery;
 template <typename InterfaceType> class TScriptInterface;
 
+/** How interaction scans find the interactable they are aiming at */
+UENUM(BlueprintType)
+enum class EInteractionTraceMode : uint8
+{
+	/** Traces through the physics scene */
+	PhysicsOnly,
+
+	/** Tests the bounds stored in the interactable index, never touching the physics scene. Doesn't account for anything blocking the trace. */
+	IndexOnly,
+
+	/** Tests the interactable index first and only traces through the physics scene if it hit an interactable, to make sure nothing blocks it */
+	IndexThenPhysicsConfirm
+};
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FInteractableObjectsChangedEvent, const TArray<FInteractionOption>&, InteractableOptions);
 
 /** Base ability task that listens for any potential interactable actors in range. */
@@ -33,16 +47,59 @@ public:
 	UPROPERTY(BlueprintAssignable)
 	FInteractableObjectsChangedEvent InteractableObjectsChanged;
 
+	/** Returns the number of option changes that were coalesced into a later broadcast instead of being broadcast on their own */
+	int32 GetNumSuppressedBroadcasts() const { return NumSuppressedBroadcasts; }
+
+	/** Returns the number of physics traces this task issued, traces served by the trace cache of the avatar aren't counted */
+	int32 GetNumTraces() const { return NumTraces; }
+
 protected:
-	/** Performs the actual line trace */
+	//~ Begin UGameplayTask Interface
+	virtual void OnDestroy(bool bInOwnerFinished) override;
+	//~ End UGameplayTask Interface
+
+	/** Performs the actual line trace, only the first blocking hit is returned */
 	static void LineTrace(FHitResult& OutHit, const UWorld* World, const FVector& Start, const FVector& End, FName ProfileName, const FCollisionQueryParams Params);
+
+	/**
+	 * Performs a line trace for the given avatar, sharing the result with every other interaction task on the same avatar.
+	 * Identical traces (same start, end, profile and ignore set) issued in the same frame only run once.
+	 */
+	void LineTraceShared(FHitResult& OutHit, const AActor* Avatar, const FVector& Start, const FVector& End, FName ProfileName, const FCollisionQueryParams& Params) const;
+
+	/**
+	 * Traces for interactables for the given avatar, using the trace mode of this task.
+	 * Falls back to a physics trace if the world has no interactable index.
+	 */
+	void TraceInteractables(FHitResult& OutHit, const AActor* Avatar, const FVector& Start, const FVector& End, FName ProfileName, const FCollisionQueryParams& Params) const;
+
 	static bool ClipCameraRayToAbilityRange(FVector CameraLocation, FVector CameraDirection, FVector AbilityCenter, float AbilityRange, FVector& OutClippedPos);
 
-	/** Aims with the owning player controller */
-	virtual void AimWithPlayerController(const AActor* InSourceActor, FCollisionQueryParams Params, const FVector& Start, float MaxRange, FVector& OutEnd, bool bIgnorePitch = false) const;
+	/**
+	 * Aims with the owning player controller
+	 *
+	 * @param OutCameraHit Optional, receives the camera hit if the camera ray was clipped to the ability range and hit something inside of it.
+	 *                     Callers can use it instead of tracing again from the start location.
+	 */
+	virtual void AimWithPlayerController(const AActor* InSourceActor, FCollisionQueryParams Params, const FVector& Start, float MaxRange, FVector& OutEnd, bool bIgnorePitch = false, FHitResult* OutCameraHit = nullptr) const;
+
+	/**
+	 * Called to update current interactable options
+	 *
+	 * @param Query The interaction query to gather the options with.
+	 * @param InteractableTargets The targets to gather the options from.
+	 * @param InstanceIndex The hit instance of instanced targets, INDEX_NONE if no instance was hit.
+	 */
+	virtual void UpdateInteractableOptions(const FInteractionQuery& Query, const TArray<TScriptInterface<IInteractableTarget>>& InteractableTargets, int32 InstanceIndex = INDEX_NONE);
 
-	/** Called to update current interactable options */
-	virtual void UpdateInteractableOptions(const FInteractionQuery& Query, const TArray<TScriptInterface<IInteractableTarget>>& InteractableTargets);
+	/**
+	 * Schedules broadcasting the current options. Changes within the coalescing window, or faster than the maximum
+	 * broadcast rate, are merged into a single broadcast of the latest options.
+	 */
+	void RequestOptionsBroadcast();
+
+	/** Broadcasts the current options, unless they didn't change since the last broadcast */
+	void BroadcastOptions();
 
 protected:
 	/** The collision profile name to use for the trace */
@@ -51,6 +108,37 @@ protected:
 	/** Whether the trace affects the aiming pitch */
 	bool bTraceAffectsAimPitch = false;
 
+	/** How traces find interactables */
+	EInteractionTraceMode TraceMode = EInteractionTraceMode::PhysicsOnly;
+
+	/** Interactables the interactable index rejects right away, see FInteractionQuery::CompileCategoryFilter */
+	FInteractableCategoryFilter CategoryFilter;
+
+	/** Owned tags of our ability system, used when the query doesn't provide the requesting tags */
+	FInteractionOwnedTagBits OwnedTagBits;
+
 	/** Cached list of current interaction options */
 	TArray<FInteractionOption> CurrentOptions;
+
+	/** The options of the last broadcast */
+	TArray<FInteractionOption> BroadcastedOptions;
+
+	/** Time option changes are collected for before they are broadcast. 0 broadcasts immediately. */
+	float BroadcastCoalesceWindow = 0.f;
+
+	/** Maximum number of broadcasts per second. 0 means unlimited. */
+	float MaxBroadcastsPerSecond = 0.f;
+
+private:
+	/** Timer for the pending broadcast */
+	FTimerHandle BroadcastTimerHandle;
+
+	/** World time of the last broadcast */
+	double LastBroadcastTime = -UE_BIG_NUMBER;
+
+	/** Number of option changes that didn't get a broadcast of their own */
+	int32 NumSuppressedBroadcasts = 0;
+
+	/** Number of physics traces issued by this task */
+	mutable int32 NumTraces = 0;
 };
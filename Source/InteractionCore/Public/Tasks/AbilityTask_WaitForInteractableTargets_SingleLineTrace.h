@@ -4,6 +4,7 @@
 
 #include "InteractionQuery.h"
 #include "AbilityTask_WaitForInteractableTargets.h"
+#include "Interfaces/IInteractionScanner.h"
 
 #include "AbilityTask_WaitForInteractableTargets_SingleLineTrace.generated.h"
 
@@ -14,7 +15,7 @@ struct FFrame;
 
 /** Ability task used to scan for interactable targets in a given radius. */
 UCLASS()
-class UAbilityTask_WaitForInteractableTargets_SingleLineTrace : public UAbilityTask_WaitForInteractableTargets
+class UAbilityTask_WaitForInteractableTargets_SingleLineTrace : public UAbilityTask_WaitForInteractableTargets, public IInteractionScanner
 {
 	GENERATED_BODY()
 
@@ -26,14 +27,27 @@ public:
 	virtual void OnDestroy(bool bInOwnerFinished) override;
 	//~ End UAbilityTask Interface
 
-	/** Waits until we trace a new set of interactables. This task automatically loops.*/
+	//~ Begin IInteractionScanner Interface
+	virtual void PerformInteractionScan() override;
+	virtual float GetInteractionScanRate() const override { return InteractionScanRate; }
+	virtual void GetInteractionScanSignificanceInputs(FInteractionScanSignificanceInputs& OutInputs) const override;
+	virtual bool GetLastInteractionScanResult(FInteractionScanResult& OutResult) const override;
+	//~ End IInteractionScanner Interface
+
+	/**
+	 * Waits until we trace a new set of interactables. This task automatically loops, InteractionScanRate is scaled by the significance of the scan.
+	 * TraceMode decides whether the trace goes through the physics scene, the interactable index or both.
+	 */
 	UFUNCTION(BlueprintCallable, Category = "Ability|Tasks", meta = (HidePin = "OwningAbility", DefaultToSelf = "OwningAbility", BlueprintInternalUseOnly = "true"))
-	static UAbilityTask_WaitForInteractableTargets_SingleLineTrace* WaitForInteractableTargets_SingleLineTrace(UGameplayAbility* OwningAbility, FInteractionQuery InteractionQuery, FCollisionProfileName TraceProfile, FGameplayAbilityTargetingLocationInfo StartLocation, float InteractionScanRange = 100.f, float InteractionScanRate = 0.1f, bool bShowDebug = false);
+	static UAbilityTask_WaitForInteractableTargets_SingleLineTrace* WaitForInteractableTargets_SingleLineTrace(UGameplayAbility* OwningAbility, FInteractionQuery InteractionQuery, FCollisionProfileName TraceProfile, FGameplayAbilityTargetingLocationInfo StartLocation, float InteractionScanRange = 100.f, float InteractionScanRate = 0.1f, bool bShowDebug = false, EInteractionTraceMode TraceMode = EInteractionTraceMode::PhysicsOnly);
 
 protected:
 	/** Performs the actual trace */
 	virtual void PerformTrace();
 
+	/** Records the interactable hit by the latest scan, returns whether focus should switch to it */
+	bool UpdateFocus(const UObject* HitTarget, int32 HitInstanceIndex, double CurrentTime);
+
 protected:
 	UPROPERTY()
 	FInteractionQuery InteractionQuery;
@@ -45,5 +59,43 @@ protected:
 	float InteractionScanRate = 0.1f;
 	bool bShowDebug = false;
 
-	FTimerHandle TimerHandle;
+	/** Distance to the interactable found by the last trace, MAX_flt if nothing was found */
+	float NearestInteractableDistance = MAX_flt;
+
+	/** The hit of the last trace */
+	FHitResult LastScanHit;
+
+	/** World time of the last trace, negative if we didn't trace yet */
+	double LastScanTime = -1.0;
+
+private:
+	/** The interactable hit by a single scan */
+	struct FFocusSample
+	{
+		TWeakObjectPtr<const UObject> Target;
+		int32 InstanceIndex = INDEX_NONE;
+
+		bool IsSameFocus(const UObject* OtherTarget, int32 OtherInstanceIndex) const
+		{
+			return Target.Get() == OtherTarget && InstanceIndex == OtherInstanceIndex;
+		}
+	};
+
+	/** Ring buffer of the most recent scans */
+	TArray<FFocusSample, TInlineAllocator<8>> FocusHistory;
+
+	/** Index of the next sample to overwrite once the history is full */
+	int32 NextFocusSampleIndex = 0;
+
+	/** The interactable that currently has focus */
+	TWeakObjectPtr<const UObject> FocusTarget;
+	int32 FocusInstanceIndex = INDEX_NONE;
+
+	/** The hit that last resolved to the focused interactable */
+	FHitResult FocusHit;
+
+	/** The interactable focus may switch to, and since when it was hit without interruption */
+	TWeakObjectPtr<const UObject> CandidateTarget;
+	int32 CandidateInstanceIndex = INDEX_NONE;
+	double CandidateStartTime = 0.0;
 };